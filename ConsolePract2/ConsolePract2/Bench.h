@@ -0,0 +1,720 @@
+#pragma once
+#include <chrono>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include "TempClass.h"
+#include "TempFunc.h"
+#include "Fft.h"
+
+using namespace std;
+
+// Лучшее время из reps запусков, в миллисекундах
+template <typename F>
+double measureMs(F fn, int reps = 3) {
+	double best = 1e300;
+	for (int r = 0; r < reps; ++r) {
+		auto start = chrono::steady_clock::now();
+		fn();
+		auto stop = chrono::steady_clock::now();
+		best = min(best, chrono::duration<double, milli>(stop - start).count());
+	}
+	return best;
+}
+
+// Прежняя раскладка Matrix: отдельный new T[cols] на каждую строку
+template <typename T>
+class NaiveMatrix {
+private:
+	T** data;
+	int rows, cols;
+public:
+	NaiveMatrix(int r, int c) : rows(r), cols(c) {
+		data = new T * [rows];
+		for (int i = 0; i < rows; ++i) {
+			data[i] = new T[cols]();
+		}
+	}
+
+	NaiveMatrix(const NaiveMatrix&) = delete;
+	NaiveMatrix& operator=(const NaiveMatrix&) = delete;
+
+	~NaiveMatrix() {
+		for (int i = 0; i < rows; ++i) {
+			delete[] data[i];
+		}
+		delete[] data;
+	}
+
+	void add(const NaiveMatrix& other, NaiveMatrix& result) const {
+		for (int i = 0; i < rows; ++i) {
+			for (int j = 0; j < cols; ++j) {
+				result.data[i][j] = data[i][j] + other.data[i][j];
+			}
+		}
+	}
+
+	void sub(const NaiveMatrix& other, NaiveMatrix& result) const {
+		for (int i = 0; i < rows; ++i) {
+			for (int j = 0; j < cols; ++j) {
+				result.data[i][j] = data[i][j] - other.data[i][j];
+			}
+		}
+	}
+
+	void multiply(const NaiveMatrix& other, NaiveMatrix& result) const {
+		for (int i = 0; i < rows; ++i) {
+			for (int j = 0; j < other.cols; ++j) {
+				T sum = 0;
+				for (int k = 0; k < cols; ++k) {
+					sum += data[i][k] * other.data[k][j];
+				}
+				result.data[i][j] = sum;
+			}
+		}
+	}
+
+	T* operator[](int row) { return data[row]; }
+};
+
+inline void benchMatrix() {
+	cout << "Matrix<float>, время в мс (лучшее из 3)\n";
+	cout << setw(6) << "n" << setw(12) << "old +" << setw(12) << "new +"
+		<< setw(12) << "old -" << setw(12) << "new -" << setw(12) << "new *s"
+		<< setw(12) << "old a+b-c" << setw(12) << "new a+b-c"
+		<< setw(14) << "old mul" << setw(14) << "new mul" << endl;
+
+	for (int n = 64; n <= 8192; n *= 2) {
+		NaiveMatrix<float> oa(n, n), ob(n, n), oc(n, n);
+		Matrix<float> na(n, n), nb(n, n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = 0; j < n; ++j) {
+				float v = static_cast<float>((i * 31 + j * 17) % 101) / 7.0f;
+				oa[i][j] = na[i][j] = v;
+				ob[i][j] = nb[i][j] = v * 0.5f + 1.0f;
+			}
+		}
+
+		double oldAdd = measureMs([&] { oa.add(ob, oc); });
+		double newAdd = measureMs([&] { Matrix<float> r = na + nb; });
+		double oldSub = measureMs([&] { oa.sub(ob, oc); });
+		double newSub = measureMs([&] { Matrix<float> r = na - nb; });
+		double newScale = measureMs([&] { Matrix<float> r = na * 2.5f; });
+		// Цепочка: прежде каждый оператор давал временную матрицу, теперь один проход
+		double oldChain = measureMs([&] { NaiveMatrix<float> t(n, n); oa.add(ob, t); t.sub(oa, oc); });
+		double newChain = measureMs([&] { Matrix<float> r = na + nb - na; });
+
+		cout << setw(6) << n << fixed << setprecision(3)
+			<< setw(12) << oldAdd << setw(12) << newAdd
+			<< setw(12) << oldSub << setw(12) << newSub << setw(12) << newScale
+			<< setw(12) << oldChain << setw(12) << newChain;
+
+		// Наивное умножение на больших размерах идёт минутами, поэтому ограничено
+		if (n <= 1024) cout << setw(14) << measureMs([&] { oa.multiply(ob, oc); }, 1);
+		else cout << setw(14) << "-";
+		if (n <= 2048) cout << setw(14) << measureMs([&] { Matrix<float> r = na.multiply(nb); }, 1);
+		else cout << setw(14) << "-";
+		cout << endl;
+	}
+}
+
+// Прежний DynamicArray: new T[] на всю ёмкость и поэлементное копирование при росте
+template <typename T>
+class NaiveDynamicArray {
+private:
+	T* data;
+	int capacity;
+	int count;
+public:
+	NaiveDynamicArray() : capacity(10), count(0) { data = new T[capacity]; }
+	NaiveDynamicArray(const NaiveDynamicArray&) = delete;
+	NaiveDynamicArray& operator=(const NaiveDynamicArray&) = delete;
+	~NaiveDynamicArray() { delete[] data; }
+
+	void add(const T& element) {
+		if (count == capacity) {
+			capacity *= 2;
+			T* newData = new T[capacity];
+			for (int i = 0; i < count; ++i) {
+				newData[i] = data[i];
+			}
+			delete[] data;
+			data = newData;
+		}
+		data[count++] = element;
+	}
+
+	int size() const { return count; }
+};
+
+inline void benchDynamicArray() {
+	const int n = 5000000;
+	const int small = 8;
+	const int smallReps = 500000;
+	string word = "достаточно длинная строка без SSO";
+
+	cout << "DynamicArray, время в мс (лучшее из 3)\n";
+	cout << setw(28) << "" << setw(12) << "old" << setw(12) << "new" << setw(12) << "vector" << endl;
+
+	cout << setw(28) << "push int x5M" << fixed << setprecision(3)
+		<< setw(12) << measureMs([&] { NaiveDynamicArray<int> a; for (int i = 0; i < n; ++i) a.add(i); })
+		<< setw(12) << measureMs([&] { DynamicArray<int> a; for (int i = 0; i < n; ++i) a.add(i); })
+		<< setw(12) << measureMs([&] { vector<int> a; for (int i = 0; i < n; ++i) a.push_back(i); }) << endl;
+
+	cout << setw(28) << "push string x500K"
+		<< setw(12) << measureMs([&] { NaiveDynamicArray<string> a; for (int i = 0; i < n / 10; ++i) a.add(word); })
+		<< setw(12) << measureMs([&] { DynamicArray<string> a; for (int i = 0; i < n / 10; ++i) a.add(word); })
+		<< setw(12) << measureMs([&] { vector<string> a; for (int i = 0; i < n / 10; ++i) a.push_back(word); }) << endl;
+
+	// Короткие массивы целиком помещаются во встроенный буфер и не трогают кучу
+	cout << setw(28) << "8 x int, 500K arrays"
+		<< setw(12) << measureMs([&] { for (int r = 0; r < smallReps; ++r) { NaiveDynamicArray<int> a; for (int i = 0; i < small; ++i) a.add(i); } })
+		<< setw(12) << measureMs([&] { for (int r = 0; r < smallReps; ++r) { DynamicArray<int, small> a; for (int i = 0; i < small; ++i) a.add(i); } })
+		<< setw(12) << measureMs([&] { for (int r = 0; r < smallReps; ++r) { vector<int> a; for (int i = 0; i < small; ++i) a.push_back(i); } }) << endl;
+}
+
+// Считает обращения к куче у std::list (счётчик общий для всех rebind-копий)
+inline size_t& countedAllocations() {
+	static size_t count = 0;
+	return count;
+}
+
+template <typename T>
+struct CountingAllocator {
+	typedef T value_type;
+
+	CountingAllocator() = default;
+	template <typename U> CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(size_t n) {
+		countedAllocations()++;
+		return allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, size_t n) { allocator<T>().deallocate(p, n); }
+
+	template <typename U> bool operator==(const CountingAllocator<U>&) const { return true; }
+	template <typename U> bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+// Прежний List: new Node на каждую вставку и delete на каждое удаление
+template <typename T>
+class NaiveList {
+private:
+	struct Node {
+		T data;
+		Node* next;
+		Node(const T& d) : data(d), next(nullptr) {}
+	};
+	Node* head;
+	Node* tail;
+public:
+	size_t allocations;
+
+	NaiveList() : head(nullptr), tail(nullptr), allocations(0) {}
+	NaiveList(const NaiveList&) = delete;
+	NaiveList& operator=(const NaiveList&) = delete;
+	~NaiveList() { while (head) popFront(); }
+
+	void pushBack(const T& data) {
+		Node* newNode = new Node(data);
+		allocations++;
+		if (!tail) head = tail = newNode;
+		else { tail->next = newNode; tail = newNode; }
+	}
+
+	void popFront() {
+		Node* temp = head;
+		head = head->next;
+		if (!head) tail = nullptr;
+		delete temp;
+	}
+};
+
+inline void benchList() {
+	const int depth = 1000;
+	const int ops = 5000000;
+
+	// Производитель/потребитель: очередь глубиной depth, ops пар push/pop
+	size_t oldAllocs = 0, stdAllocs = 0, newAllocs = 0;
+	double oldMs = measureMs([&] {
+		NaiveList<int> l;
+		for (int i = 0; i < depth; ++i) l.pushBack(i);
+		for (int i = 0; i < ops; ++i) { l.pushBack(i); l.popFront(); }
+		oldAllocs = l.allocations;
+	});
+	double stdMs = measureMs([&] {
+		countedAllocations() = 0;
+		list<int, CountingAllocator<int>> l;
+		for (int i = 0; i < depth; ++i) l.push_back(i);
+		for (int i = 0; i < ops; ++i) { l.push_back(i); l.pop_front(); }
+		stdAllocs = countedAllocations();
+	});
+	double newMs = measureMs([&] {
+		List<int> l;
+		for (int i = 0; i < depth; ++i) l.pushBack(i);
+		for (int i = 0; i < ops; ++i) { l.pushBack(i); l.popFront(); }
+		newAllocs = l.getPool()->slabCount();
+	});
+
+	cout << "List<int>, " << ops << " push/pop при глубине " << depth << " (лучшее из 3)\n";
+	cout << setw(12) << "" << setw(14) << "мс" << setw(14) << "выделений" << setw(14) << "Mops/s" << endl;
+	cout << fixed << setprecision(3);
+	cout << setw(12) << "old" << setw(14) << oldMs << setw(14) << oldAllocs << setw(14) << 2.0 * ops / oldMs / 1000 << endl;
+	cout << setw(12) << "std::list" << setw(14) << stdMs << setw(14) << stdAllocs << setw(14) << 2.0 * ops / stdMs / 1000 << endl;
+	cout << setw(12) << "new" << setw(14) << newMs << setw(14) << newAllocs << setw(14) << 2.0 * ops / newMs / 1000 << endl;
+
+	// splice целого списка туда и обратно между двумя списками со своими пулами
+	const int length = 1 << 20;
+	const int rounds = 1000;
+	list<int> sa(static_cast<size_t>(length), 1), sb(static_cast<size_t>(length), 2);
+	List<int> na, nb;
+	for (int i = 0; i < length; ++i) { na.pushBack(1); nb.pushBack(2); }
+	double stdSplice = measureMs([&] {
+		for (int r = 0; r < rounds; ++r) { sa.splice(sa.end(), sb); sb.splice(sb.end(), sa); }
+	});
+	double newSplice = measureMs([&] {
+		for (int r = 0; r < rounds; ++r) { na.splice(na.end(), nb); nb.splice(nb.end(), na); }
+	});
+	cout << "\nsplice списка из " << length << " элементов, " << 2 * rounds << " переносов (лучшее из 3), мс\n";
+	cout << setw(12) << "std::list" << setw(14) << stdSplice << endl;
+	cout << setw(12) << "new" << setw(14) << newSplice << "   (" << na.size() + nb.size() << ")" << endl;
+}
+
+// Прежний Queue под мьютексом - то, как его приходилось делить между потоками
+template <typename T>
+class LockedQueue {
+	Queue<T> queue;
+	mutex lock;
+public:
+	void enqueue(const T& value) {
+		lock_guard<mutex> guard(lock);
+		queue.enqueue(value);
+	}
+
+	bool tryDequeue(T& out) {
+		lock_guard<mutex> guard(lock);
+		if (queue.empty()) return false;
+		out = queue.front();
+		queue.dequeue();
+		return true;
+	}
+};
+
+// threads потоков поровну делятся на производителей и потребителей; один поток делает и то и другое
+template <typename Q>
+double runQueueContention(Q& queue, int threads, long long items) {
+	auto start = chrono::steady_clock::now();
+	if (threads == 1) {
+		int value;
+		for (long long i = 0; i < items; ++i) {
+			queue.enqueue(static_cast<int>(i));
+			queue.tryDequeue(value);
+		}
+	}
+	else {
+		int producers = threads / 2, consumers = threads - producers;
+		atomic<long long> consumed(0);
+		vector<thread> pool;
+		for (int p = 0; p < producers; ++p) {
+			pool.emplace_back([&, p] {
+				for (long long i = p; i < items; i += producers) queue.enqueue(static_cast<int>(i));
+			});
+		}
+		for (int c = 0; c < consumers; ++c) {
+			pool.emplace_back([&] {
+				int value;
+				while (consumed.load(memory_order_relaxed) < items) {
+					if (queue.tryDequeue(value)) consumed.fetch_add(1, memory_order_relaxed);
+					else this_thread::yield();
+				}
+			});
+		}
+		for (auto& t : pool) t.join();
+	}
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+inline void benchQueue() {
+	const long long items = 1000000;
+	cout << "Queue<int>, " << items << " элементов, Mops/s\n";
+	cout << setw(10) << "потоков" << setw(16) << "list+mutex" << setw(16) << "RingQueue" << endl;
+	for (int threads = 1; threads <= 64; threads *= 2) {
+		LockedQueue<int> locked;
+		RingQueue<int> ring(4096);
+		double lockedMs = runQueueContention(locked, threads, items);
+		double ringMs = runQueueContention(ring, threads, items);
+		cout << setw(10) << threads << fixed << setprecision(2)
+			<< setw(16) << items / lockedMs / 1000 << setw(16) << items / ringMs / 1000 << endl;
+	}
+}
+
+// Прежние скалярные версии редукций из TempFunc.h - эталон для сравнения
+template <typename T> T scalarArraySum(const T* a, int n) {
+	T sum = 0;
+	for (int i = 0; i < n; i++) sum += a[i];
+	return sum;
+}
+
+template <typename T> T scalarMin(const T* a, int n) {
+	T temp = a[0];
+	for (int i = 0; i < n; i++) if (a[i] < temp) temp = a[i];
+	return temp;
+}
+
+template <typename T> T scalarSecondMax(const T* a, int n) {
+	T max1 = max(a[0], a[1]), max2 = min(a[0], a[1]);
+	for (int i = 2; i < n; ++i) {
+		if (a[i] > max1) { max2 = max1; max1 = a[i]; }
+		else if (a[i] > max2) max2 = a[i];
+	}
+	return max2;
+}
+
+template <typename T> int scalarFindIndex(const T* a, int n, const T& value) {
+	for (int i = 0; i < n; ++i) if (a[i] == value) return i;
+	return -1;
+}
+
+// Строка в духе Google Benchmark: время одной итерации и пропускная способность
+template <typename F>
+void reportBenchmark(const string& name, int n, F fn) {
+	int iterations = max(1, (1 << 26) / n);
+	double ms = measureMs([&] { for (int i = 0; i < iterations; ++i) fn(); });
+	double ns = ms * 1e6 / iterations;
+	cout << left << setw(44) << name + "/" + to_string(n) << right << fixed << setprecision(0)
+		<< setw(14) << ns << " ns" << setw(12) << iterations
+		<< setprecision(2) << setw(12) << n / ns << " G items/s" << endl;
+}
+
+template <typename T>
+void benchReductionsFor(const string& type) {
+	volatile double sink = 0;
+	for (int n : { 1 << 10, 1 << 16, 1 << 20, 1 << 24 }) {
+		vector<T> data(n);
+		for (int i = 0; i < n; ++i) data[i] = static_cast<T>(i * 7919LL % 100003);
+		const T* a = data.data();
+		T missing = static_cast<T>(-1);
+
+		reportBenchmark("BM_arraySum<" + type + ">/scalar", n, [&] { sink = sink + scalarArraySum(a, n); });
+		reportBenchmark("BM_arraySum<" + type + ">/simd", n, [&] { sink = sink + arraySum(a, n); });
+		reportBenchmark("BM_minmass<" + type + ">/scalar", n, [&] { sink = sink + scalarMin(a, n); });
+		reportBenchmark("BM_minmass<" + type + ">/simd", n, [&] { sink = sink + minmass(data.data(), n); });
+		reportBenchmark("BM_findSecondMax<" + type + ">/scalar", n, [&] { sink = sink + scalarSecondMax(a, n); });
+		reportBenchmark("BM_findSecondMax<" + type + ">/simd", n, [&] { sink = sink + findSecondMax(a, n); });
+		reportBenchmark("BM_average<" + type + ">/scalar", n, [&] { sink = sink + static_cast<double>(scalarArraySum(a, n)) / n; });
+		reportBenchmark("BM_average<" + type + ">/simd", n, [&] { sink = sink + average(a, n); });
+		reportBenchmark("BM_findIndex<" + type + ">/scalar", n, [&] { sink = sink + scalarFindIndex(a, n, missing); });
+		reportBenchmark("BM_findIndex<" + type + ">/simd", n, [&] { sink = sink + findIndex(a, n, missing); });
+	}
+}
+
+inline void benchReductions() {
+	const simd::CpuFeatures& f = simd::cpu();
+	cout << "Набор команд: " << (f.avx512f ? "AVX-512" : f.avx2 ? "AVX2" : "SSE2") << endl;
+	cout << left << setw(44) << "Benchmark" << right << setw(17) << "Time" << setw(12) << "Iterations" << endl;
+	benchReductionsFor<float>("float");
+	benchReductionsFor<double>("double");
+	benchReductionsFor<int>("int");
+}
+
+// Старая сортировка пузырьком из TempFunc.h - для сравнения на малых размерах
+template <typename T>
+void bubbleSortReference(T arr[], int size) {
+	for (int i = 0; i < size - 1; ++i) {
+		for (int j = 0; j < size - i - 1; ++j) {
+			if (arr[j] > arr[j + 1]) {
+				swap(arr[j], arr[j + 1]);
+			}
+		}
+	}
+}
+
+// Вход для сортировки: 0 - случайный, 1 - упорядоченный, 2 - обратный, 3 - мало разных значений
+template <typename T, typename Make>
+vector<T> sortInput(int n, int kind, Make make) {
+	vector<T> data(static_cast<size_t>(n));
+	unsigned long long state = 88172645463325252ULL;
+	for (int i = 0; i < n; ++i) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		long long key = kind == 0 ? static_cast<long long>(state % 1000000007ULL)
+			: kind == 1 ? i : kind == 2 ? n - i : static_cast<long long>(state % 16);
+		data[i] = make(key);
+	}
+	return data;
+}
+
+// Время одной сортировки без учёта копирования входа
+template <typename T, typename F>
+double sortMs(const vector<T>& input, F sortFn) {
+	vector<T> work;
+	double copyMs = measureMs([&] { work = input; });
+	double totalMs = measureMs([&] { work = input; sortFn(work); });
+	return max(0.0, totalMs - copyMs);
+}
+
+template <typename T, typename Make>
+void benchSortFor(const string& type, int n, Make make) {
+	const char* kinds[] = { "random", "sorted", "reversed", "few unique" };
+	cout << type << ", n = " << n << ", время в мс (лучшее из 3)\n";
+	cout << left << setw(12) << "input" << right << setw(12) << "std::sort" << setw(12) << "introsort"
+		<< setw(12) << "radix" << setw(12) << "parallel" << setw(12) << "auto" << endl;
+	for (int kind = 0; kind < 4; ++kind) {
+		vector<T> input = sortInput<T>(n, kind, make);
+		cout << left << setw(12) << kinds[kind] << right << fixed << setprecision(2)
+			<< setw(12) << sortMs(input, [](vector<T>& v) { sort(v.begin(), v.end()); });
+		for (SortPolicy policy : { SortPolicy::Introsort, SortPolicy::Radix, SortPolicy::Parallel, SortPolicy::Auto })
+			cout << setw(12) << sortMs(input, [policy](vector<T>& v) { sorting::sort(v.begin(), v.end(), policy); });
+		cout << endl;
+	}
+	cout << endl;
+}
+
+inline void benchSort() {
+	cout << "Потоков: " << hardwareThreads() << "\n\n";
+
+	const int small = 20000;
+	vector<int> input = sortInput<int>(small, 0, [](long long k) { return static_cast<int>(k); });
+	cout << "int, n = " << small << ": пузырёк " << fixed << setprecision(2)
+		<< sortMs(input, [](vector<int>& v) { bubbleSortReference(v.data(), static_cast<int>(v.size())); })
+		<< " мс, sortArray " << sortMs(input, [](vector<int>& v) { sortArray(v.data(), static_cast<int>(v.size())); })
+		<< " мс\n\n";
+
+	benchSortFor<int>("int", 1 << 22, [](long long k) { return static_cast<int>(k); });
+	benchSortFor<double>("double", 1 << 22, [](long long k) { return static_cast<double>(k) / 7.0 - 1e5; });
+	benchSortFor<string>("string", 1 << 19, [](long long k) { return "key" + to_string(k); });
+}
+
+// Прежний filterArray: предикат дважды на элемент и буфер через new[]
+template <typename T, typename Predicate>
+T* twoPassFilter(const T arr[], int size, Predicate pred, int& resultSize) {
+	resultSize = 0;
+	for (int i = 0; i < size; ++i) {
+		if (pred(arr[i])) {
+			resultSize++;
+		}
+	}
+
+	T* result = new T[resultSize];
+	int index = 0;
+	for (int i = 0; i < size; ++i) {
+		if (pred(arr[i])) {
+			result[index++] = arr[i];
+		}
+	}
+	return result;
+}
+
+inline void benchFilter() {
+	const int n = 1 << 24;
+	vector<float> data = sortInput<float>(n, 0, [](long long k) { return static_cast<float>(k % 1000); });
+	vector<float> dest(static_cast<size_t>(n));
+	cout << "filterArray, float, n = " << n << ", время в мс (лучшее из 3)\n";
+	cout << setw(12) << "selected" << setw(12) << "old" << setw(12) << "lambda" << setw(12) << "simd"
+		<< setw(12) << "parallel" << endl;
+	for (float threshold : { 10.0f, 500.0f, 990.0f }) {
+		auto lambda = [threshold](float x) { return x < threshold; };
+		simd::Compare<float> pred = simd::lessThan(threshold);
+		cout << fixed << setprecision(2) << setw(12) << threshold / 1000
+			<< setw(12) << measureMs([&] { int size; delete[] twoPassFilter(data.data(), n, lambda, size); })
+			<< setw(12) << measureMs([&] { filterArray(data.data(), n, lambda, dest.data()); })
+			<< setw(12) << measureMs([&] { filterArray(data.data(), n, pred, dest.data()); })
+			<< setw(12) << measureMs([&] { parallelFilter(data.data(), n, pred, dest.data()); }) << endl;
+	}
+}
+
+// Прежний arrayIntersection через два std::set
+template <typename T>
+vector<T> setIntersectionReference(const T arr1[], int size1, const T arr2[], int size2) {
+	set<T> set1(arr1, arr1 + size1);
+	set<T> set2(arr2, arr2 + size2);
+	vector<T> result;
+	set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), back_inserter(result));
+	return result;
+}
+
+inline void benchIntersection() {
+	struct Case {
+		const char* name;
+		int smallSize, bigSize;
+		bool sorted;
+	};
+	const Case cases[] = {
+		{ "1K x 1M sorted", 1000, 1 << 20, true },
+		{ "1M x 1M sorted", 1 << 20, 1 << 20, true },
+		{ "1M x 1M random", 1 << 20, 1 << 20, false },
+	};
+
+	cout << "arrayIntersection, int, время в мс (лучшее из 3)\n";
+	cout << left << setw(18) << "input" << right << setw(12) << "std::set" << setw(12) << "merge"
+		<< setw(12) << "gallop" << setw(12) << "hash" << setw(12) << "auto" << endl;
+	for (const Case& c : cases) {
+		// Возрастающие последовательности с разным шагом, чтобы совпадала часть элементов
+		vector<int> small(static_cast<size_t>(c.smallSize)), big(static_cast<size_t>(c.bigSize));
+		for (int i = 0; i < c.smallSize; ++i) small[i] = static_cast<int>(static_cast<long long>(i) * 3 * c.bigSize / c.smallSize);
+		for (int i = 0; i < c.bigSize; ++i) big[i] = i * 2;
+		if (!c.sorted) {
+			reverse(small.begin(), small.end());
+			for (int i = 0; i + 1 < c.bigSize; i += 2) swap(big[i], big[c.bigSize - 1 - i]);
+		}
+
+		size_t sink = 0;
+		cout << left << setw(18) << c.name << right << fixed << setprecision(2)
+			<< setw(12) << measureMs([&] { sink += setIntersectionReference(small.data(), c.smallSize, big.data(), c.bigSize).size(); }, 1);
+		for (SetStrategy strategy : { SetStrategy::Merge, SetStrategy::Gallop, SetStrategy::Hash, SetStrategy::Auto }) {
+			if (!c.sorted && (strategy == SetStrategy::Merge || strategy == SetStrategy::Gallop)) {
+				cout << setw(12) << "-";
+				continue;
+			}
+			cout << setw(12) << measureMs([&] { sink += arrayIntersection(small.data(), c.smallSize, big.data(), c.bigSize, strategy).size(); });
+		}
+		cout << "   (" << sink << ")" << endl;
+	}
+}
+
+template <typename M>
+void runMapOps(const string& name, const vector<int>& keys, const vector<int>& misses) {
+	size_t sink = 0;
+	M m;
+	double insertMs = measureMs([&] { m = M(); for (size_t i = 0; i < keys.size(); ++i) m[keys[i]] = static_cast<int>(i); }, 1);
+	double hitMs = measureMs([&] { for (int k : keys) sink += m.find(k) != m.end(); });
+	double missMs = measureMs([&] { for (int k : misses) sink += m.find(k) != m.end(); });
+	double eraseMs = measureMs([&] { M copy = m; for (size_t i = 0; i < keys.size(); i += 2) copy.erase(keys[i]); sink += copy.size(); }, 1);
+	cout << left << setw(16) << name << right << fixed << setprecision(2) << setw(12) << insertMs << setw(12) << hitMs
+		<< setw(12) << missMs << setw(12) << eraseMs << "   (" << sink << ")" << endl;
+}
+
+inline void benchFlatMap() {
+	const int n = 1 << 20;
+	vector<int> keys(static_cast<size_t>(n)), misses(static_cast<size_t>(n));
+	unsigned state = 12345;
+	for (int i = 0; i < n; ++i) {
+		state = state * 1103515245u + 12345u;
+		keys[i] = static_cast<int>(state >> 1) | 1;
+		misses[i] = keys[i] & ~1;
+	}
+
+	cout << "int -> int, n = " << n << ", время в мс\n";
+	cout << left << setw(16) << "" << right << setw(12) << "insert" << setw(12) << "find hit"
+		<< setw(12) << "find miss" << setw(12) << "copy+erase" << endl;
+	runMapOps<map<int, int>>("std::map", keys, misses);
+	runMapOps<unordered_map<int, int>>("unordered_map", keys, misses);
+	runMapOps<FlatMap<int, int>>("FlatMap", keys, misses);
+
+	// Строковые ключи: FlatMap ищет по const char* без временной string
+	const int words = 1 << 18;
+	vector<string> names(static_cast<size_t>(words));
+	for (int i = 0; i < words; ++i) names[i] = "user_" + to_string(keys[i]);
+	map<string, int> sm;
+	unordered_map<string, int> um;
+	FlatMap<string, int> fm;
+	for (int i = 0; i < words; ++i) sm[names[i]] = um[names[i]] = fm[names[i]] = i;
+	size_t sink = 0;
+	cout << "\nstring -> int, " << words << " поисков по const char*, время в мс\n";
+	cout << left << setw(16) << "std::map" << right << setw(12) << measureMs([&] { for (const string& s : names) sink += sm.count(s.c_str()); }) << endl;
+	cout << left << setw(16) << "unordered_map" << right << setw(12) << measureMs([&] { for (const string& s : names) sink += um.count(s.c_str()); }) << endl;
+	cout << left << setw(16) << "FlatMap" << right << setw(12) << measureMs([&] { for (const string& s : names) sink += fm.count(s.c_str()); })
+		<< "   (" << sink << ")" << endl;
+}
+
+inline void benchTriangles() {
+	const int n = 1 << 22;
+	vector<Triangle<float>> triangles;
+	triangles.reserve(static_cast<size_t>(n));
+	unsigned state = 7;
+	auto next = [&] { state = state * 1664525u + 1013904223u; return static_cast<float>(state >> 8) / (1 << 24) * 100.0f; };
+	for (int i = 0; i < n; ++i) {
+		float x = next(), y = next();
+		triangles.emplace_back(Point<float>(x, y), Point<float>(x + next() / 50, y), Point<float>(x, y + next() / 50));
+	}
+	TriangleBatch<float> batch(triangles);
+	vector<float> a(static_cast<size_t>(n)), b(static_cast<size_t>(n)), c(static_cast<size_t>(n)), d(static_cast<size_t>(n));
+	vector<double> areas(static_cast<size_t>(n));
+	vector<uint8_t> inside(static_cast<size_t>(n));
+	Point<float> probe(50.0f, 50.0f);
+
+	cout << "Triangle<float> x " << n << ", время в мс (лучшее из 3), потоков: " << hardwareThreads() << "\n";
+	cout << left << setw(16) << "" << right << setw(14) << "Triangle" << setw(14) << "batch x1" << setw(14) << "batch xN" << endl;
+	cout << left << setw(16) << "area" << right << fixed << setprecision(2)
+		<< setw(14) << measureMs([&] { for (int i = 0; i < n; ++i) areas[i] = triangles[i].area(); })
+		<< setw(14) << measureMs([&] { batch.area(a.data(), 1); })
+		<< setw(14) << measureMs([&] { batch.area(a.data()); }) << endl;
+	cout << left << setw(16) << "centroid" << right << setw(14) << "-"
+		<< setw(14) << measureMs([&] { batch.centroid(a.data(), b.data(), 1); })
+		<< setw(14) << measureMs([&] { batch.centroid(a.data(), b.data()); }) << endl;
+	cout << left << setw(16) << "aabb" << right << setw(14) << "-"
+		<< setw(14) << measureMs([&] { batch.aabb(a.data(), b.data(), c.data(), d.data(), 1); })
+		<< setw(14) << measureMs([&] { batch.aabb(a.data(), b.data(), c.data(), d.data()); }) << endl;
+	cout << left << setw(16) << "contains" << right << setw(14) << "-"
+		<< setw(14) << measureMs([&] { batch.contains(probe, inside.data(), 1); })
+		<< setw(14) << measureMs([&] { batch.contains(probe, inside.data()); }) << endl;
+}
+
+// Учебный рекурсивный radix-2: новые векторы и множители на каждом уровне
+inline void recursiveFft(vector<complex<double>>& a) {
+	size_t n = a.size();
+	if (n == 1) return;
+	vector<complex<double>> even(n / 2), odd(n / 2);
+	for (size_t i = 0; i < n / 2; ++i) {
+		even[i] = a[2 * i];
+		odd[i] = a[2 * i + 1];
+	}
+	recursiveFft(even);
+	recursiveFft(odd);
+	for (size_t k = 0; k < n / 2; ++k) {
+		complex<double> t = polar(1.0, -2 * 3.14159265358979323846 * k / n) * odd[k];
+		a[k] = even[k] + t;
+		a[k + n / 2] = even[k] - t;
+	}
+}
+
+inline void benchFft() {
+	vector<size_t> sizes;
+	for (int bits = 8; bits <= 22; bits += 2) sizes.push_back(size_t(1) << bits);
+	// Длины не степени двойки идут через смешанное основание
+	for (size_t n : { size_t(1000), size_t(59049), size_t(78125), size_t(248832) }) sizes.push_back(n);
+
+	cout << "БПФ, время в мс (лучшее из 3), err - макс. ошибка forward + inverse для double\n";
+	cout << left << setw(10) << "n" << right << setw(12) << "recursive" << setw(12) << "plan"
+		<< setw(12) << "double" << setw(12) << "float" << setw(12) << "err" << endl;
+	for (size_t n : sizes) {
+		ComplexArray<double> x(n), y(n), back(n);
+		ComplexArray<float> xf(n), yf(n);
+		vector<complex<double>> reference(n);
+		unsigned state = 11;
+		for (size_t i = 0; i < n; ++i) {
+			state = state * 1664525u + 1013904223u;
+			double re = static_cast<double>(state >> 8) / (1 << 24) - 0.5;
+			state = state * 1664525u + 1013904223u;
+			double im = static_cast<double>(state >> 8) / (1 << 24) - 0.5;
+			x.set(i, Complex<double>(re, im));
+			xf.set(i, Complex<float>(static_cast<float>(re), static_cast<float>(im)));
+		}
+
+		cout << left << setw(10) << n << right << fixed << setprecision(2);
+		if ((n & (n - 1)) == 0) {
+			cout << setw(12) << measureMs([&] {
+				for (size_t i = 0; i < n; ++i) reference[i] = complex<double>(x.realData()[i], x.imagData()[i]);
+				recursiveFft(reference);
+			}, 1);
+		}
+		else cout << setw(12) << "-";
+
+		FftPlan<double> plan(n);
+		FftPlan<float> planf(n);
+		cout << setw(12) << measureMs([&] { FftPlan<double> fresh(n); })
+			<< setw(12) << measureMs([&] { plan.forward(x, y); })
+			<< setw(12) << measureMs([&] { planf.forward(xf, yf); });
+
+		plan.inverse(y, back);
+		double err = 0;
+		for (size_t i = 0; i < n; ++i) {
+			err = max(err, fabs(back.realData()[i] - x.realData()[i]));
+			err = max(err, fabs(back.imagData()[i] - x.imagData()[i]));
+		}
+		cout << setw(12) << scientific << setprecision(1) << err << endl;
+	}
+}
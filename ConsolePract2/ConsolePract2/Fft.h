@@ -0,0 +1,252 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Simd.h"
+#include "TempClass.h"
+
+using namespace std;
+
+// План БПФ фиксированной длины n. Поворотные множители, перестановка и разложение n
+// считаются один раз в конструкторе; forward/inverse только читают план, поэтому один
+// план можно переиспользовать между вызовами и потоками.
+// Степень двойки - итеративный radix-2 с векторными бабочками, остальные длины - смешанное
+// основание 4, 2, 3 и прочие простые. Большой простой множитель p стоит O(p^2) на блок
+template <typename T>
+class FftPlan {
+	static_assert(is_floating_point<T>::value, "FftPlan requires a floating point type");
+
+	// Этапы внутри блока такой длины делаются подряд, пока блок лежит в кеше
+	static constexpr size_t blockSize = size_t(1) << 13;
+	// Короче этого бабочки этапа считаются скалярно: вызов ядра не окупается
+	static constexpr size_t vectorHalf = 16;
+
+	size_t n;
+	bool powerOfTwo;
+	vector<size_t> reversed;    // бит-реверсная перестановка
+	vector<T> stageRe, stageIm; // множители этапов подряд: этап с половиной h начинается с h - 1
+	vector<size_t> factors;
+	size_t maxFactor;
+	vector<T> twRe, twIm;       // exp(-2pi i k / n), k < n
+
+	static void twiddle(size_t k, size_t len, T& re, T& im) {
+		const double pi = 3.14159265358979323846;
+		double angle = -2.0 * pi * static_cast<double>(k) / static_cast<double>(len);
+		re = static_cast<T>(cos(angle));
+		im = static_cast<T>(sin(angle));
+	}
+
+	void stages(T* re, T* im, size_t from, size_t to, size_t halfFrom, size_t halfTo) const {
+		for (size_t half = halfFrom; half < halfTo; half *= 2) {
+			const T* wr = stageRe.data() + half - 1;
+			const T* wi = stageIm.data() + half - 1;
+			for (size_t k = from; k < to; k += 2 * half) {
+				T* xr = re + k;
+				T* xi = im + k;
+				T* yr = xr + half;
+				T* yi = xi + half;
+				if (half >= vectorHalf) {
+					simd::butterfly(xr, xi, yr, yi, wr, wi, half);
+					continue;
+				}
+				for (size_t j = 0; j < half; ++j) {
+					T tr = yr[j] * wr[j] - yi[j] * wi[j], ti = yr[j] * wi[j] + yi[j] * wr[j];
+					yr[j] = xr[j] - tr;
+					yi[j] = xi[j] - ti;
+					xr[j] += tr;
+					xi[j] += ti;
+				}
+			}
+		}
+	}
+
+	void radix2(const T* inRe, const T* inIm, T* outRe, T* outIm) const {
+		if (inRe == outRe) {
+			for (size_t i = 0; i < n; ++i) {
+				if (i < reversed[i]) {
+					swap(outRe[i], outRe[reversed[i]]);
+					swap(outIm[i], outIm[reversed[i]]);
+				}
+			}
+		}
+		else {
+			for (size_t i = 0; i < n; ++i) {
+				outRe[i] = inRe[reversed[i]];
+				outIm[i] = inIm[reversed[i]];
+			}
+		}
+		size_t block = min(n, blockSize);
+		for (size_t from = 0; from < n; from += block) stages(outRe, outIm, from, from + block, 1, block);
+		stages(outRe, outIm, 0, n, block, n);
+	}
+
+	// Блок длины p * m: out[q * m + k] уже содержит ДПФ длины m q-й прореженной подпоследовательности.
+	// tr и ti - рабочие массивы не короче p
+	void combine(T* re, T* im, size_t stride, size_t p, size_t m, T* tr, T* ti) const {
+		for (size_t k = 0; k < m; ++k) {
+			for (size_t q = 0; q < p; ++q) {
+				T xr = re[q * m + k], xi = im[q * m + k];
+				size_t t = q * k * stride;
+				tr[q] = xr * twRe[t] - xi * twIm[t];
+				ti[q] = xr * twIm[t] + xi * twRe[t];
+			}
+			if (p == 2) {
+				re[k] = tr[0] + tr[1];
+				im[k] = ti[0] + ti[1];
+				re[m + k] = tr[0] - tr[1];
+				im[m + k] = ti[0] - ti[1];
+			}
+			else if (p == 4) {
+				T sr = tr[0] + tr[2], si = ti[0] + ti[2], dr = tr[0] - tr[2], di = ti[0] - ti[2];
+				T pr = tr[1] + tr[3], pi = ti[1] + ti[3], mr = tr[1] - tr[3], mi = ti[1] - ti[3];
+				re[k] = sr + pr;
+				im[k] = si + pi;
+				re[m + k] = dr + mi;
+				im[m + k] = di - mr;
+				re[2 * m + k] = sr - pr;
+				im[2 * m + k] = si - pi;
+				re[3 * m + k] = dr - mi;
+				im[3 * m + k] = di + mr;
+			}
+			else if (p == 3) {
+				const T c = static_cast<T>(0.86602540378443864676);
+				T sr = tr[1] + tr[2], si = ti[1] + ti[2], dr = tr[1] - tr[2], di = ti[1] - ti[2];
+				T hr = tr[0] - sr / 2, hi = ti[0] - si / 2;
+				re[k] = tr[0] + sr;
+				im[k] = ti[0] + si;
+				re[m + k] = hr + c * di;
+				im[m + k] = hi - c * dr;
+				re[2 * m + k] = hr - c * di;
+				im[2 * m + k] = hi + c * dr;
+			}
+			else {
+				size_t unit = n / p;
+				for (size_t r = 0; r < p; ++r) {
+					T sr = tr[0], si = ti[0];
+					for (size_t q = 1; q < p; ++q) {
+						size_t t = (q * r) % p * unit;
+						sr += tr[q] * twRe[t] - ti[q] * twIm[t];
+						si += tr[q] * twIm[t] + ti[q] * twRe[t];
+					}
+					re[r * m + k] = sr;
+					im[r * m + k] = si;
+				}
+			}
+		}
+	}
+
+	void mixed(const T* inRe, const T* inIm, size_t stride, T* outRe, T* outIm, size_t len, size_t level, T* scratch) const {
+		size_t p = factors[level], m = len / p;
+		if (m == 1) {
+			for (size_t q = 0; q < p; ++q) {
+				outRe[q] = inRe[q * stride];
+				outIm[q] = inIm[q * stride];
+			}
+		}
+		else {
+			for (size_t q = 0; q < p; ++q)
+				mixed(inRe + q * stride, inIm + q * stride, stride * p, outRe + q * m, outIm + q * m, m, level + 1, scratch);
+		}
+		combine(outRe, outIm, stride, p, m, scratch, scratch + maxFactor);
+	}
+
+	void transform(const T* inRe, const T* inIm, T* outRe, T* outIm) const {
+		if (n == 1) {
+			outRe[0] = inRe[0];
+			outIm[0] = inIm[0];
+			return;
+		}
+		// radix-2 умеет работать на месте, смешанное основание пишет в out, ещё читая in
+		bool inPlace = inRe == outRe && inIm == outIm;
+		bool overlap = inRe == outRe || inRe == outIm || inIm == outRe || inIm == outIm;
+		if (overlap && !(inPlace && powerOfTwo)) {
+			vector<T> re(inRe, inRe + n), im(inIm, inIm + n);
+			transform(re.data(), im.data(), outRe, outIm);
+			return;
+		}
+		if (powerOfTwo) {
+			radix2(inRe, inIm, outRe, outIm);
+			return;
+		}
+		// Рабочий буфер свой у каждого потока и переживает вызовы: план остаётся только для чтения
+		static thread_local vector<T> scratch;
+		if (scratch.size() < 2 * maxFactor) scratch.resize(2 * maxFactor);
+		mixed(inRe, inIm, 1, outRe, outIm, n, 0, scratch.data());
+	}
+
+	void checkSize(size_t size) const {
+		if (size != n) throw invalid_argument("Array size must match the FFT plan size");
+	}
+
+public:
+	explicit FftPlan(size_t size) : n(size), powerOfTwo(false), maxFactor(0) {
+		if (n == 0) throw invalid_argument("FFT size must be positive");
+		powerOfTwo = (n & (n - 1)) == 0;
+		if (powerOfTwo) {
+			int bits = 0;
+			while ((size_t(1) << bits) < n) ++bits;
+			reversed.resize(n);
+			for (size_t i = 0; i < n; ++i) {
+				size_t r = 0;
+				for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1) << (bits - 1 - b);
+				reversed[i] = r;
+			}
+			stageRe.resize(n > 1 ? n - 1 : 0);
+			stageIm.resize(stageRe.size());
+			for (size_t half = 1; half < n; half *= 2)
+				for (size_t j = 0; j < half; ++j) twiddle(j, 2 * half, stageRe[half - 1 + j], stageIm[half - 1 + j]);
+			return;
+		}
+		size_t rest = n;
+		while (rest % 4 == 0) { factors.push_back(4); rest /= 4; }
+		while (rest % 2 == 0) { factors.push_back(2); rest /= 2; }
+		for (size_t p = 3; p * p <= rest; p += 2)
+			while (rest % p == 0) { factors.push_back(p); rest /= p; }
+		if (rest > 1) factors.push_back(rest);
+		maxFactor = *max_element(factors.begin(), factors.end());
+		twRe.resize(n);
+		twIm.resize(n);
+		for (size_t k = 0; k < n; ++k) twiddle(k, n, twRe[k], twIm[k]);
+	}
+
+	size_t size() const { return n; }
+
+	// Прямое преобразование без нормировки; выход может совпадать со входом
+	void forward(const T* inRe, const T* inIm, T* outRe, T* outIm) const { transform(inRe, inIm, outRe, outIm); }
+
+	// Обратное с делением на n: прямое над массивами с переставленными re и im
+	void inverse(const T* inRe, const T* inIm, T* outRe, T* outIm) const {
+		transform(inIm, inRe, outIm, outRe);
+		T factor = T(1) / static_cast<T>(n);
+		simd::scale(outRe, factor, outRe, n);
+		simd::scale(outIm, factor, outIm, n);
+	}
+
+	void forward(const ComplexArray<T>& in, ComplexArray<T>& out) const {
+		checkSize(in.size());
+		out.resize(n);
+		forward(in.realData(), in.imagData(), out.realData(), out.imagData());
+	}
+
+	void inverse(const ComplexArray<T>& in, ComplexArray<T>& out) const {
+		checkSize(in.size());
+		out.resize(n);
+		inverse(in.realData(), in.imagData(), out.realData(), out.imagData());
+	}
+
+	ComplexArray<T> forward(const ComplexArray<T>& in) const {
+		ComplexArray<T> out(n);
+		forward(in, out);
+		return out;
+	}
+
+	ComplexArray<T> inverse(const ComplexArray<T>& in) const {
+		ComplexArray<T> out(n);
+		inverse(in, out);
+		return out;
+	}
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+// Указатели опасности (hazard pointers) для lock-free структур: поток публикует
+// адрес узла, который читает, и такой узел нельзя удалять, пока адрес опубликован.
+// Каждый поток занимает один слот на всё время жизни
+const int maxHazardThreads = 128;
+
+struct alignas(64) HazardSlot {
+	atomic<thread::id> owner;
+	atomic<void*> pointer;
+
+	HazardSlot() : owner(thread::id()), pointer(nullptr) {}
+};
+
+inline HazardSlot* hazardSlots() {
+	static HazardSlot slots[maxHazardThreads];
+	return slots;
+}
+
+class HazardOwner {
+	HazardSlot* slot;
+public:
+	HazardOwner() : slot(nullptr) {
+		HazardSlot* slots = hazardSlots();
+		for (int i = 0; i < maxHazardThreads; ++i) {
+			thread::id free;
+			if (slots[i].owner.compare_exchange_strong(free, this_thread::get_id())) {
+				slot = &slots[i];
+				return;
+			}
+		}
+		throw runtime_error("No hazard pointers available");
+	}
+
+	HazardOwner(const HazardOwner&) = delete;
+	HazardOwner& operator=(const HazardOwner&) = delete;
+
+	~HazardOwner() {
+		slot->pointer.store(nullptr);
+		slot->owner.store(thread::id());
+	}
+
+	atomic<void*>& pointer() { return slot->pointer; }
+};
+
+inline atomic<void*>& hazardPointerForThisThread() {
+	thread_local HazardOwner owner;
+	return owner.pointer();
+}
+
+inline bool isHazardous(const void* p) {
+	HazardSlot* slots = hazardSlots();
+	for (int i = 0; i < maxHazardThreads; ++i) {
+		if (slots[i].pointer.load() == p) return true;
+	}
+	return false;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+inline int hardwareThreads() {
+	unsigned n = thread::hardware_concurrency();
+	return n == 0 ? 1 : static_cast<int>(n);
+}
+
+// Делит [begin, end) на куски не меньше grain и вызывает fn(lo, hi) для каждого в своём потоке
+template <typename F>
+void parallelFor(long long begin, long long end, long long grain, F fn, int threads = 0) {
+	long long total = end - begin;
+	if (total <= 0) return;
+	if (threads <= 0) threads = hardwareThreads();
+	if (grain < 1) grain = 1;
+
+	long long chunks = min<long long>(threads, (total + grain - 1) / grain);
+	if (chunks <= 1) {
+		fn(begin, end);
+		return;
+	}
+
+	vector<thread> pool;
+	pool.reserve(static_cast<size_t>(chunks - 1));
+	long long step = total / chunks, rest = total % chunks;
+	long long lo = begin;
+	for (long long c = 0; c < chunks; ++c) {
+		long long hi = lo + step + (c < rest ? 1 : 0);
+		if (c + 1 == chunks) fn(lo, hi);
+		else pool.emplace_back(fn, lo, hi);
+		lo = hi;
+	}
+	for (auto& t : pool) t.join();
+}
@@ -0,0 +1,273 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Simd.h"
+#include "Sort.h"
+
+using namespace std;
+
+// Способ пересечения/разности для setops
+enum class SetStrategy {
+	Auto,   // по упорядоченности входов и отношению их размеров
+	Merge,  // слияние упорядоченных входов (для int32 без повторов - SIMD)
+	Gallop, // экспоненциальный поиск элементов меньшего входа в большем
+	Hash    // хеш-множество из меньшего входа, входы могут быть не упорядочены
+};
+
+// Все операции возвращают упорядоченный результат без повторов
+namespace setops {
+	// С какого отношения размеров галоп выгоднее слияния
+	const size_t gallopRatio = 32;
+
+	template <typename T, typename = void>
+	struct IsHashable : false_type {};
+
+	template <typename T>
+	struct IsHashable<T, void_t<decltype(hash<T>()(declval<const T&>()))>> : is_default_constructible<hash<T>> {};
+
+	// Множество с открытой адресацией и линейным пробированием, заполнено не больше чем наполовину
+	template <typename T>
+	class OpenHashSet {
+	private:
+		vector<T> slots;
+		vector<unsigned char> state; // 0 - пусто, 1 - занято, 2 - занято и уже найдено
+		size_t mask;
+		int shift;
+
+		size_t home(const T& value) const {
+			// Фибоначчиево хеширование: старшие биты произведения перемешаны лучше младших
+			uint64_t h = static_cast<uint64_t>(hash<T>()(value)) * 0x9E3779B97F4A7C15ULL;
+			return static_cast<size_t>(h >> shift);
+		}
+
+	public:
+		explicit OpenHashSet(size_t expected) {
+			size_t capacity = 16;
+			shift = 60;
+			while (capacity < expected * 2) {
+				capacity *= 2;
+				--shift;
+			}
+			slots.resize(capacity);
+			state.assign(capacity, 0);
+			mask = capacity - 1;
+		}
+
+		void insert(const T& value) {
+			for (size_t i = home(value);; i = (i + 1) & mask) {
+				if (state[i] == 0) {
+					slots[i] = value;
+					state[i] = 1;
+					return;
+				}
+				if (slots[i] == value) return;
+			}
+		}
+
+		bool contains(const T& value) const {
+			for (size_t i = home(value);; i = (i + 1) & mask) {
+				if (state[i] == 0) return false;
+				if (slots[i] == value) return true;
+			}
+		}
+
+		// true только при первом обнаружении значения
+		bool takeFirst(const T& value) {
+			for (size_t i = home(value);; i = (i + 1) & mask) {
+				if (state[i] == 0) return false;
+				if (slots[i] == value) {
+					if (state[i] == 2) return false;
+					state[i] = 2;
+					return true;
+				}
+			}
+		}
+	};
+
+	template <typename T>
+	bool strictlyIncreasing(const T* a, size_t n) {
+		for (size_t i = 1; i < n; ++i) if (!(a[i - 1] < a[i])) return false;
+		return true;
+	}
+
+	// Первый элемент a[from..n), не меньший value: сначала шаги 1, 2, 4..., затем двоичный поиск
+	template <typename T>
+	size_t gallop(const T* a, size_t from, size_t n, const T& value) {
+		size_t bound = 1;
+		while (from + bound < n && a[from + bound] < value) bound *= 2;
+		const T* first = a + from + bound / 2;
+		const T* last = a + min(from + bound + 1, n);
+		return static_cast<size_t>(lower_bound(first, last, value) - a);
+	}
+
+	// Упорядоченная копия без повторов
+	template <typename T>
+	vector<T> normalized(const T* a, size_t n) {
+		vector<T> result(a, a + n);
+		if (!is_sorted(result.begin(), result.end())) sorting::sort(result.begin(), result.end());
+		result.erase(unique(result.begin(), result.end()), result.end());
+		return result;
+	}
+
+	template <typename T>
+	void mergeIntersect(const T* a, size_t na, const T* b, size_t nb, vector<T>& out) {
+		if constexpr (is_same<T, int32_t>::value) {
+			if (strictlyIncreasing(a, na) && strictlyIncreasing(b, nb)) {
+				out.resize(min(na, nb));
+				out.resize(simd::intersectSorted(a, na, b, nb, out.data()));
+				return;
+			}
+		}
+		out.clear();
+		size_t i = 0, j = 0;
+		while (i < na && j < nb) {
+			if (a[i] < b[j]) ++i;
+			else if (b[j] < a[i]) ++j;
+			else {
+				if (out.empty() || out.back() < a[i]) out.push_back(a[i]);
+				++i;
+				++j;
+			}
+		}
+	}
+
+	// small заметно короче big; оба упорядочены
+	template <typename T>
+	void gallopIntersect(const T* small, size_t ns, const T* big, size_t nb, vector<T>& out) {
+		out.clear();
+		size_t pos = 0;
+		for (size_t i = 0; i < ns && pos < nb; ++i) {
+			if (i > 0 && !(small[i - 1] < small[i])) continue;
+			pos = gallop(big, pos, nb, small[i]);
+			if (pos < nb && !(small[i] < big[pos])) out.push_back(small[i]);
+		}
+	}
+
+	template <typename T>
+	void hashIntersect(const T* a, size_t na, const T* b, size_t nb, vector<T>& out) {
+		if (na > nb) {
+			swap(a, b);
+			swap(na, nb);
+		}
+		OpenHashSet<T> set(na);
+		for (size_t i = 0; i < na; ++i) set.insert(a[i]);
+		out.clear();
+		for (size_t i = 0; i < nb; ++i) if (set.takeFirst(b[i])) out.push_back(b[i]);
+		sorting::sort(out.begin(), out.end());
+	}
+
+	template <typename T>
+	vector<T> intersect(const T* a, size_t na, const T* b, size_t nb, SetStrategy strategy = SetStrategy::Auto) {
+		vector<T> out;
+		if (na == 0 || nb == 0) return out;
+		if (na > nb) {
+			swap(a, b);
+			swap(na, nb);
+		}
+
+		if (strategy == SetStrategy::Auto) {
+			bool bigSorted = is_sorted(b, b + nb);
+			if (bigSorted && nb / na >= gallopRatio) {
+				// Меньший вход дешевле упорядочить, чем обходить больший целиком
+				if (is_sorted(a, a + na)) gallopIntersect(a, na, b, nb, out);
+				else {
+					vector<T> small = normalized(a, na);
+					gallopIntersect(small.data(), small.size(), b, nb, out);
+				}
+				return out;
+			}
+			if (bigSorted && is_sorted(a, a + na)) strategy = SetStrategy::Merge;
+			else if constexpr (IsHashable<T>::value) strategy = SetStrategy::Hash;
+			else {
+				vector<T> sa = normalized(a, na), sb = normalized(b, nb);
+				mergeIntersect(sa.data(), sa.size(), sb.data(), sb.size(), out);
+				return out;
+			}
+		}
+
+		switch (strategy) {
+		case SetStrategy::Gallop:
+			gallopIntersect(a, na, b, nb, out);
+			break;
+		case SetStrategy::Hash:
+			if constexpr (IsHashable<T>::value) {
+				hashIntersect(a, na, b, nb, out);
+				break;
+			}
+			// нет hash<T> - как слияние
+		default:
+			mergeIntersect(a, na, b, nb, out);
+			break;
+		}
+		return out;
+	}
+
+	// Пересечение нескольких входов: от меньшего к большему, промежуточный результат
+	// упорядочен, поэтому с ростом разницы размеров Auto переходит на галоп
+	template <typename T>
+	vector<T> intersectAll(vector<pair<const T*, size_t>> inputs, SetStrategy strategy = SetStrategy::Auto) {
+		if (inputs.empty()) return vector<T>();
+		sort(inputs.begin(), inputs.end(), [](const pair<const T*, size_t>& x, const pair<const T*, size_t>& y) {
+			return x.second < y.second;
+		});
+		vector<T> result = normalized(inputs[0].first, inputs[0].second);
+		for (size_t k = 1; k < inputs.size() && !result.empty(); ++k)
+			result = intersect(result.data(), result.size(), inputs[k].first, inputs[k].second, strategy);
+		return result;
+	}
+
+	template <typename T>
+	vector<T> unite(const T* a, size_t na, const T* b, size_t nb) {
+		vector<T> sa = normalized(a, na), sb = normalized(b, nb);
+		vector<T> out;
+		out.reserve(sa.size() + sb.size());
+		set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), back_inserter(out));
+		return out;
+	}
+
+	// Элементы a, которых нет в b
+	template <typename T>
+	vector<T> difference(const T* a, size_t na, const T* b, size_t nb, SetStrategy strategy = SetStrategy::Auto) {
+		if (nb == 0) return normalized(a, na);
+		vector<T> sa = normalized(a, na);
+		vector<T> out;
+		out.reserve(sa.size());
+
+		if (strategy == SetStrategy::Auto) {
+			if (is_sorted(b, b + nb)) strategy = nb / max<size_t>(sa.size(), 1) >= gallopRatio ? SetStrategy::Gallop : SetStrategy::Merge;
+			else strategy = IsHashable<T>::value ? SetStrategy::Hash : SetStrategy::Merge;
+		}
+
+		if (strategy == SetStrategy::Gallop) {
+			size_t pos = 0;
+			for (const T& x : sa) {
+				pos = gallop(b, pos, nb, x);
+				if (pos == nb || x < b[pos]) out.push_back(x);
+			}
+			return out;
+		}
+		if constexpr (IsHashable<T>::value) {
+			if (strategy == SetStrategy::Hash) {
+				OpenHashSet<T> set(nb);
+				for (size_t i = 0; i < nb; ++i) set.insert(b[i]);
+				for (const T& x : sa) if (!set.contains(x)) out.push_back(x);
+				return out;
+			}
+		}
+		vector<T> sb;
+		const T* bb = b;
+		size_t bn = nb;
+		if (!is_sorted(b, b + nb)) {
+			sb = normalized(b, nb);
+			bb = sb.data();
+			bn = sb.size();
+		}
+		set_difference(sa.begin(), sa.end(), bb, bb + bn, back_inserter(out));
+		return out;
+	}
+}
@@ -0,0 +1,1244 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC разрешает AVX-интринсики в любой функции, GCC/Clang - только с атрибутом target
+#if defined(SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#endif
+
+namespace simd {
+
+	const size_t kAlignment = 64;
+
+	struct CpuFeatures {
+		bool sse2 = false;
+		bool avx2 = false;
+		bool avx512f = false;
+	};
+
+	inline CpuFeatures detectCpu() {
+		CpuFeatures f;
+#if defined(SIMD_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		f.sse2 = (info[3] & (1 << 26)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool fma = (info[2] & (1 << 12)) != 0;
+		bool ymmSaved = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+		// ZMM-регистры и маски ОС тоже должна сохранять (биты 5-7 XCR0)
+		bool zmmSaved = osxsave && (_xgetbv(0) & 0xE6) == 0xE6;
+		if (maxLeaf >= 7 && ymmSaved && fma) {
+			__cpuidex(info, 7, 0);
+			f.avx2 = (info[1] & (1 << 5)) != 0;
+			f.avx512f = zmmSaved && (info[1] & (1 << 16)) != 0;
+		}
+#elif defined(SIMD_X86)
+		__builtin_cpu_init();
+		f.sse2 = __builtin_cpu_supports("sse2");
+		f.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		f.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+		return f;
+	}
+
+	inline const CpuFeatures& cpu() {
+		static const CpuFeatures features = detectCpu();
+		return features;
+	}
+
+	inline void* alignedAlloc(size_t bytes) {
+		return ::operator new(bytes, std::align_val_t(kAlignment));
+	}
+
+	inline void alignedFree(void* p) {
+		::operator delete(p, std::align_val_t(kAlignment));
+	}
+
+	// Сколько элементов T занимает строка длины n после дополнения до kAlignment
+	template <typename T>
+	size_t paddedCount(size_t n) {
+		if (kAlignment % sizeof(T) != 0) return n;
+		size_t perLine = kAlignment / sizeof(T);
+		return (n + perLine - 1) / perLine * perLine;
+	}
+
+	template <typename T>
+	constexpr bool isVectorizable() {
+		return std::is_same<T, float>::value || std::is_same<T, double>::value ||
+			std::is_same<T, int32_t>::value;
+	}
+
+#ifdef SIMD_X86
+	namespace avx2 {
+		SIMD_TARGET_AVX2 inline void add(const float* a, const float* b, float* out, size_t n) {
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+			for (; i < n; ++i) out[i] = a[i] + b[i];
+		}
+		SIMD_TARGET_AVX2 inline void add(const double* a, const double* b, double* out, size_t n) {
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+			for (; i < n; ++i) out[i] = a[i] + b[i];
+		}
+		SIMD_TARGET_AVX2 inline void add(const int32_t* a, const int32_t* b, int32_t* out, size_t n) {
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+				__m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+				_mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi32(va, vb));
+			}
+			for (; i < n; ++i) out[i] = a[i] + b[i];
+		}
+
+		SIMD_TARGET_AVX2 inline void sub(const float* a, const float* b, float* out, size_t n) {
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+			for (; i < n; ++i) out[i] = a[i] - b[i];
+		}
+		SIMD_TARGET_AVX2 inline void sub(const double* a, const double* b, double* out, size_t n) {
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+			for (; i < n; ++i) out[i] = a[i] - b[i];
+		}
+		SIMD_TARGET_AVX2 inline void sub(const int32_t* a, const int32_t* b, int32_t* out, size_t n) {
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+				__m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+				_mm256_storeu_si256((__m256i*)(out + i), _mm256_sub_epi32(va, vb));
+			}
+			for (; i < n; ++i) out[i] = a[i] - b[i];
+		}
+
+		SIMD_TARGET_AVX2 inline void scale(const float* a, float s, float* out, size_t n) {
+			__m256 vs = _mm256_set1_ps(s);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), vs));
+			for (; i < n; ++i) out[i] = a[i] * s;
+		}
+		SIMD_TARGET_AVX2 inline void scale(const double* a, double s, double* out, size_t n) {
+			__m256d vs = _mm256_set1_pd(s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), vs));
+			for (; i < n; ++i) out[i] = a[i] * s;
+		}
+		SIMD_TARGET_AVX2 inline void scale(const int32_t* a, int32_t s, int32_t* out, size_t n) {
+			__m256i vs = _mm256_set1_epi32(s);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+				_mm256_storeu_si256((__m256i*)(out + i), _mm256_mullo_epi32(va, vs));
+			}
+			for (; i < n; ++i) out[i] = a[i] * s;
+		}
+
+		// out += s * x
+		SIMD_TARGET_AVX2 inline void axpy(float s, const float* x, float* out, size_t n) {
+			__m256 vs = _mm256_set1_ps(s);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_fmadd_ps(vs, _mm256_loadu_ps(x + i), _mm256_loadu_ps(out + i)));
+			for (; i < n; ++i) out[i] += s * x[i];
+		}
+		SIMD_TARGET_AVX2 inline void axpy(double s, const double* x, double* out, size_t n) {
+			__m256d vs = _mm256_set1_pd(s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm256_storeu_pd(out + i, _mm256_fmadd_pd(vs, _mm256_loadu_pd(x + i), _mm256_loadu_pd(out + i)));
+			for (; i < n; ++i) out[i] += s * x[i];
+		}
+		SIMD_TARGET_AVX2 inline void axpy(int32_t s, const int32_t* x, int32_t* out, size_t n) {
+			__m256i vs = _mm256_set1_epi32(s);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256i vx = _mm256_loadu_si256((const __m256i*)(x + i));
+				__m256i vo = _mm256_loadu_si256((const __m256i*)(out + i));
+				_mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi32(vo, _mm256_mullo_epi32(vx, vs)));
+			}
+			for (; i < n; ++i) out[i] += s * x[i];
+		}
+	}
+
+	namespace sse {
+		inline void add(const float* a, const float* b, float* out, size_t n) {
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			for (; i < n; ++i) out[i] = a[i] + b[i];
+		}
+		inline void add(const double* a, const double* b, double* out, size_t n) {
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2)
+				_mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			for (; i < n; ++i) out[i] = a[i] + b[i];
+		}
+		inline void add(const int32_t* a, const int32_t* b, int32_t* out, size_t n) {
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				__m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+				__m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+				_mm_storeu_si128((__m128i*)(out + i), _mm_add_epi32(va, vb));
+			}
+			for (; i < n; ++i) out[i] = a[i] + b[i];
+		}
+
+		inline void sub(const float* a, const float* b, float* out, size_t n) {
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			for (; i < n; ++i) out[i] = a[i] - b[i];
+		}
+		inline void sub(const double* a, const double* b, double* out, size_t n) {
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2)
+				_mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			for (; i < n; ++i) out[i] = a[i] - b[i];
+		}
+		inline void sub(const int32_t* a, const int32_t* b, int32_t* out, size_t n) {
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				__m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+				__m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+				_mm_storeu_si128((__m128i*)(out + i), _mm_sub_epi32(va, vb));
+			}
+			for (; i < n; ++i) out[i] = a[i] - b[i];
+		}
+
+		inline void scale(const float* a, float s, float* out, size_t n) {
+			__m128 vs = _mm_set1_ps(s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), vs));
+			for (; i < n; ++i) out[i] = a[i] * s;
+		}
+		inline void scale(const double* a, double s, double* out, size_t n) {
+			__m128d vs = _mm_set1_pd(s);
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2)
+				_mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), vs));
+			for (; i < n; ++i) out[i] = a[i] * s;
+		}
+
+		inline void axpy(float s, const float* x, float* out, size_t n) {
+			__m128 vs = _mm_set1_ps(s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(vs, _mm_loadu_ps(x + i))));
+			for (; i < n; ++i) out[i] += s * x[i];
+		}
+		inline void axpy(double s, const double* x, double* out, size_t n) {
+			__m128d vs = _mm_set1_pd(s);
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2)
+				_mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(out + i), _mm_mul_pd(vs, _mm_loadu_pd(x + i))));
+			for (; i < n; ++i) out[i] += s * x[i];
+		}
+	}
+#endif
+
+	// Поэлементные операции над буферами: AVX2 при поддержке процессором, иначе SSE2, иначе скалярно
+	template <typename T>
+	void add(const T* a, const T* b, T* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx2) { avx2::add(a, b, out, n); return; }
+			sse::add(a, b, out, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+	}
+
+	template <typename T>
+	void sub(const T* a, const T* b, T* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx2) { avx2::sub(a, b, out, n); return; }
+			sse::sub(a, b, out, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+	}
+
+	template <typename T>
+	void scale(const T* a, T s, T* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx2) { avx2::scale(a, s, out, n); return; }
+			if constexpr (!std::is_integral<T>::value) { sse::scale(a, s, out, n); return; }
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) out[i] = a[i] * s;
+	}
+
+	template <typename T>
+	void axpy(T s, const T* x, T* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx2) { avx2::axpy(s, x, out, n); return; }
+			if constexpr (!std::is_integral<T>::value) { sse::axpy(s, x, out, n); return; }
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) out[i] += s * x[i];
+	}
+}
+
+namespace simd {
+
+	inline int lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	// Значение, не превосходящее ни один элемент (для float/double - минус бесконечность)
+	template <typename T>
+	T lowestValue() {
+		if constexpr (std::numeric_limits<T>::has_infinity) return -std::numeric_limits<T>::infinity();
+		else return std::numeric_limits<T>::lowest();
+	}
+
+	// Два наибольших элемента мультимножества: first >= second
+	template <typename T>
+	void pushTopTwo(T value, T& first, T& second) {
+		if (value > first) {
+			second = first;
+			first = value;
+		}
+		else if (value > second) {
+			second = value;
+		}
+	}
+
+	inline int popCount(unsigned mask) {
+#ifdef _MSC_VER
+		mask = mask - ((mask >> 1) & 0x55555555u);
+		mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+		return static_cast<int>((((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#else
+		return __builtin_popcount(mask);
+#endif
+	}
+
+	// Простой предикат "x op value", который умеет проверяться сразу над вектором
+	enum class CmpOp { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+	template <CmpOp Op, typename T>
+	bool compareScalar(const T& x, const T& value) {
+		if constexpr (Op == CmpOp::Less) return x < value;
+		else if constexpr (Op == CmpOp::LessEqual) return x <= value;
+		else if constexpr (Op == CmpOp::Greater) return x > value;
+		else if constexpr (Op == CmpOp::GreaterEqual) return x >= value;
+		else if constexpr (Op == CmpOp::Equal) return x == value;
+		else return x != value;
+	}
+
+	template <typename T>
+	struct Compare {
+		CmpOp op;
+		T value;
+
+		bool operator()(const T& x) const {
+			switch (op) {
+			case CmpOp::Less: return x < value;
+			case CmpOp::LessEqual: return x <= value;
+			case CmpOp::Greater: return x > value;
+			case CmpOp::GreaterEqual: return x >= value;
+			case CmpOp::Equal: return x == value;
+			default: return x != value;
+			}
+		}
+	};
+
+	template <typename T> Compare<T> lessThan(T value) { return Compare<T>{ CmpOp::Less, value }; }
+	template <typename T> Compare<T> lessOrEqual(T value) { return Compare<T>{ CmpOp::LessEqual, value }; }
+	template <typename T> Compare<T> greaterThan(T value) { return Compare<T>{ CmpOp::Greater, value }; }
+	template <typename T> Compare<T> greaterOrEqual(T value) { return Compare<T>{ CmpOp::GreaterEqual, value }; }
+	template <typename T> Compare<T> equalTo(T value) { return Compare<T>{ CmpOp::Equal, value }; }
+	template <typename T> Compare<T> notEqualTo(T value) { return Compare<T>{ CmpOp::NotEqual, value }; }
+
+	// Упорядоченные сравнения для float/double (NaN даёт false, для != - true, как у скалярных операторов)
+	constexpr int floatPredicate(CmpOp op) {
+		return op == CmpOp::Less ? 0x11 /* _CMP_LT_OQ */ : op == CmpOp::LessEqual ? 0x12 /* _CMP_LE_OQ */
+			: op == CmpOp::Greater ? 0x1E /* _CMP_GT_OQ */ : op == CmpOp::GreaterEqual ? 0x1D /* _CMP_GE_OQ */
+			: op == CmpOp::Equal ? 0x00 /* _CMP_EQ_OQ */ : 0x04 /* _CMP_NEQ_UQ */;
+	}
+
+	constexpr int intPredicate(CmpOp op) {
+		return op == CmpOp::Less ? 1 /* _MM_CMPINT_LT */ : op == CmpOp::LessEqual ? 2 /* _MM_CMPINT_LE */
+			: op == CmpOp::Greater ? 6 /* _MM_CMPINT_NLE */ : op == CmpOp::GreaterEqual ? 5 /* _MM_CMPINT_NLT */
+			: op == CmpOp::Equal ? 0 /* _MM_CMPINT_EQ */ : 4 /* _MM_CMPINT_NE */;
+	}
+
+	// Для каждой 8-битной маски - номера выбранных 32-битных дорожек подряд, по байту на номер
+	struct CompressTable {
+		uint64_t lanes[256];
+
+		CompressTable() {
+			for (unsigned m = 0; m < 256; ++m) {
+				uint64_t packed = 0;
+				int k = 0;
+				for (int lane = 0; lane < 8; ++lane)
+					if (m & (1u << lane)) packed |= static_cast<uint64_t>(lane) << (8 * k++);
+				lanes[m] = packed;
+			}
+		}
+	};
+
+	inline const CompressTable& compressTable() {
+		static const CompressTable table;
+		return table;
+	}
+
+	// Точка на прямой вырожденного i-го треугольника (v - шесть столбцов ax, ay, bx, by, cx, cy):
+	// такой треугольник - отрезок, и точка лежит на нём, если попадает в его габариты
+	template <typename T>
+	bool segmentHit(const T* const* v, size_t i, T px, T py) {
+		return px >= std::min(std::min(v[0][i], v[2][i]), v[4][i]) && px <= std::max(std::max(v[0][i], v[2][i]), v[4][i])
+			&& py >= std::min(std::min(v[1][i], v[3][i]), v[5][i]) && py <= std::max(std::max(v[1][i], v[3][i]), v[5][i]);
+	}
+
+#ifdef SIMD_X86
+	// Обобщённые ядра редукций над набором операций O (тип вектора, загрузка, min/max, сравнение).
+	// Разворачиваются отдельно в каждом пространстве ISA, потому что GCC требует target на самой функции
+#define SIMD_REDUCTION_KERNELS(TARGET) \
+	template <typename O> TARGET typename O::Scalar sum(const typename O::Scalar* a, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		typename O::Vec acc0 = O::zero(), acc1 = O::zero(), acc2 = O::zero(), acc3 = O::zero(); \
+		size_t i = 0; \
+		for (; i + 4 * w <= n; i += 4 * w) { \
+			acc0 = O::add(acc0, O::load(a + i)); \
+			acc1 = O::add(acc1, O::load(a + i + w)); \
+			acc2 = O::add(acc2, O::load(a + i + 2 * w)); \
+			acc3 = O::add(acc3, O::load(a + i + 3 * w)); \
+		} \
+		for (; i + w <= n; i += w) acc0 = O::add(acc0, O::load(a + i)); \
+		S lanes[O::width]; \
+		O::store(lanes, O::add(O::add(acc0, acc1), O::add(acc2, acc3))); \
+		S result = 0; \
+		for (size_t l = 0; l < w; ++l) result += lanes[l]; \
+		for (; i < n; ++i) result += a[i]; \
+		return result; \
+	} \
+	template <typename O> TARGET typename O::Scalar minimum(const typename O::Scalar* a, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		typename O::Vec m0 = O::set1(a[0]), m1 = m0, m2 = m0, m3 = m0; \
+		size_t i = 0; \
+		for (; i + 4 * w <= n; i += 4 * w) { \
+			m0 = O::min(m0, O::load(a + i)); \
+			m1 = O::min(m1, O::load(a + i + w)); \
+			m2 = O::min(m2, O::load(a + i + 2 * w)); \
+			m3 = O::min(m3, O::load(a + i + 3 * w)); \
+		} \
+		for (; i + w <= n; i += w) m0 = O::min(m0, O::load(a + i)); \
+		S lanes[O::width]; \
+		O::store(lanes, O::min(O::min(m0, m1), O::min(m2, m3))); \
+		S result = lanes[0]; \
+		for (size_t l = 1; l < w; ++l) if (lanes[l] < result) result = lanes[l]; \
+		for (; i < n; ++i) if (a[i] < result) result = a[i]; \
+		return result; \
+	} \
+	template <typename O> TARGET typename O::Scalar secondMax(const typename O::Scalar* a, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		const S lowest = lowestValue<S>(); \
+		typename O::Vec hiA = O::set1(lowest), loA = hiA, hiB = hiA, loB = hiA; \
+		size_t i = 0; \
+		for (; i + 2 * w <= n; i += 2 * w) { \
+			typename O::Vec x = O::load(a + i), y = O::load(a + i + w); \
+			loA = O::max(loA, O::min(hiA, x)); \
+			hiA = O::max(hiA, x); \
+			loB = O::max(loB, O::min(hiB, y)); \
+			hiB = O::max(hiB, y); \
+		} \
+		S lanes[4][O::width]; \
+		O::store(lanes[0], hiA); O::store(lanes[1], loA); O::store(lanes[2], hiB); O::store(lanes[3], loB); \
+		S first = lowest, second = lowest; \
+		for (size_t r = 0; r < 4; ++r) for (size_t l = 0; l < w; ++l) pushTopTwo(lanes[r][l], first, second); \
+		for (; i < n; ++i) pushTopTwo(a[i], first, second); \
+		return second; \
+	} \
+	template <typename O> TARGET size_t find(const typename O::Scalar* a, size_t n, typename O::Scalar value) { \
+		const size_t w = O::width; \
+		typename O::Vec key = O::set1(value); \
+		size_t i = 0; \
+		for (; i + 2 * w <= n; i += 2 * w) { \
+			unsigned m0 = O::equalMask(O::load(a + i), key); \
+			unsigned m1 = O::equalMask(O::load(a + i + w), key); \
+			if (m0) return i + lowestBit(m0); \
+			if (m1) return i + w + lowestBit(m1); \
+		} \
+		for (; i < n; ++i) if (a[i] == value) return i; \
+		return n; \
+	} \
+	template <typename O, CmpOp Op> TARGET size_t compress(const typename O::Scalar* a, size_t n, typename O::Scalar value, typename O::Scalar* out) { \
+		const size_t w = O::width; \
+		typename O::Vec key = O::set1(value); \
+		size_t count = 0, i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec x = O::load(a + i); \
+			unsigned m = O::template compareMask<Op>(x, key); \
+			O::compressStore(out + count, x, m); \
+			count += popCount(m); \
+		} \
+		for (; i < n; ++i) if (compareScalar<Op>(a[i], value)) out[count++] = a[i]; \
+		return count; \
+	}
+
+	// Ядра для пачки треугольников в SoA-виде: координаты вершин a, b, c лежат в шести массивах
+#define SIMD_TRIANGLE_KERNELS(TARGET) \
+	template <typename O> TARGET void triangleArea(const typename O::Scalar* const* v, typename O::Scalar* out, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		typename O::Vec half = O::set1(S(0.5)), zero = O::zero(); \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec ax = O::load(v[0] + i), ay = O::load(v[1] + i); \
+			typename O::Vec abx = O::sub(O::load(v[2] + i), ax), aby = O::sub(O::load(v[3] + i), ay); \
+			typename O::Vec acx = O::sub(O::load(v[4] + i), ax), acy = O::sub(O::load(v[5] + i), ay); \
+			typename O::Vec cross = O::sub(O::mul(abx, acy), O::mul(acx, aby)); \
+			O::store(out + i, O::mul(O::max(cross, O::sub(zero, cross)), half)); \
+		} \
+		for (; i < n; ++i) { \
+			S cross = (v[2][i] - v[0][i]) * (v[5][i] - v[1][i]) - (v[4][i] - v[0][i]) * (v[3][i] - v[1][i]); \
+			out[i] = (cross < 0 ? -cross : cross) * S(0.5); \
+		} \
+	} \
+	template <typename O> TARGET void triangleCentroid(const typename O::Scalar* const* v, typename O::Scalar* outX, typename O::Scalar* outY, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		typename O::Vec third = O::set1(S(1) / S(3)); \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			O::store(outX + i, O::mul(O::add(O::add(O::load(v[0] + i), O::load(v[2] + i)), O::load(v[4] + i)), third)); \
+			O::store(outY + i, O::mul(O::add(O::add(O::load(v[1] + i), O::load(v[3] + i)), O::load(v[5] + i)), third)); \
+		} \
+		for (; i < n; ++i) { \
+			outX[i] = (v[0][i] + v[2][i] + v[4][i]) * (S(1) / S(3)); \
+			outY[i] = (v[1][i] + v[3][i] + v[5][i]) * (S(1) / S(3)); \
+		} \
+	} \
+	template <typename O> TARGET void triangleBounds(const typename O::Scalar* const* v, typename O::Scalar* const* out, size_t n) { \
+		const size_t w = O::width; \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec ax = O::load(v[0] + i), ay = O::load(v[1] + i); \
+			typename O::Vec bx = O::load(v[2] + i), by = O::load(v[3] + i); \
+			typename O::Vec cx = O::load(v[4] + i), cy = O::load(v[5] + i); \
+			O::store(out[0] + i, O::min(O::min(ax, bx), cx)); \
+			O::store(out[1] + i, O::min(O::min(ay, by), cy)); \
+			O::store(out[2] + i, O::max(O::max(ax, bx), cx)); \
+			O::store(out[3] + i, O::max(O::max(ay, by), cy)); \
+		} \
+		for (; i < n; ++i) { \
+			out[0][i] = std::min(std::min(v[0][i], v[2][i]), v[4][i]); \
+			out[1][i] = std::min(std::min(v[1][i], v[3][i]), v[5][i]); \
+			out[2][i] = std::max(std::max(v[0][i], v[2][i]), v[4][i]); \
+			out[3][i] = std::max(std::max(v[1][i], v[3][i]), v[5][i]); \
+		} \
+	} \
+	/* Точка внутри (или на границе), если три векторных произведения не разных знаков. \
+	   Все три равны нулю только у вырожденного треугольника и точки на его прямой - \
+	   тогда это отрезок, и точка должна попасть в его габариты */ \
+	template <typename O> TARGET void triangleContains(const typename O::Scalar* const* v, typename O::Scalar px, typename O::Scalar py, uint8_t* out, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		typename O::Vec x = O::set1(px), y = O::set1(py), zero = O::zero(); \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec ax = O::load(v[0] + i), ay = O::load(v[1] + i); \
+			typename O::Vec bx = O::load(v[2] + i), by = O::load(v[3] + i); \
+			typename O::Vec cx = O::load(v[4] + i), cy = O::load(v[5] + i); \
+			typename O::Vec d1 = O::sub(O::mul(O::sub(bx, ax), O::sub(y, ay)), O::mul(O::sub(by, ay), O::sub(x, ax))); \
+			typename O::Vec d2 = O::sub(O::mul(O::sub(cx, bx), O::sub(y, by)), O::mul(O::sub(cy, by), O::sub(x, bx))); \
+			typename O::Vec d3 = O::sub(O::mul(O::sub(ax, cx), O::sub(y, cy)), O::mul(O::sub(ay, cy), O::sub(x, cx))); \
+			unsigned negative = O::template compareMask<CmpOp::Less>(d1, zero) | O::template compareMask<CmpOp::Less>(d2, zero) \
+				| O::template compareMask<CmpOp::Less>(d3, zero); \
+			unsigned positive = O::template compareMask<CmpOp::Greater>(d1, zero) | O::template compareMask<CmpOp::Greater>(d2, zero) \
+				| O::template compareMask<CmpOp::Greater>(d3, zero); \
+			unsigned outside = negative & positive; \
+			unsigned flat = ~(negative | positive) & ((1u << w) - 1); \
+			if (flat) { \
+				outside |= flat & (O::template compareMask<CmpOp::Less>(x, O::min(O::min(ax, bx), cx)) \
+					| O::template compareMask<CmpOp::Greater>(x, O::max(O::max(ax, bx), cx)) \
+					| O::template compareMask<CmpOp::Less>(y, O::min(O::min(ay, by), cy)) \
+					| O::template compareMask<CmpOp::Greater>(y, O::max(O::max(ay, by), cy))); \
+			} \
+			for (size_t l = 0; l < w; ++l) out[i + l] = static_cast<uint8_t>(((outside >> l) & 1) ^ 1); \
+		} \
+		for (; i < n; ++i) { \
+			S d1 = (v[2][i] - v[0][i]) * (py - v[1][i]) - (v[3][i] - v[1][i]) * (px - v[0][i]); \
+			S d2 = (v[4][i] - v[2][i]) * (py - v[3][i]) - (v[5][i] - v[3][i]) * (px - v[2][i]); \
+			S d3 = (v[0][i] - v[4][i]) * (py - v[5][i]) - (v[1][i] - v[5][i]) * (px - v[4][i]); \
+			bool negative = d1 < 0 || d2 < 0 || d3 < 0, positive = d1 > 0 || d2 > 0 || d3 > 0; \
+			out[i] = static_cast<uint8_t>(negative || positive ? !(negative && positive) : segmentHit(v, i, px, py)); \
+		} \
+	}
+
+	// Ядра для комплексных массивов в раздельном виде: действительные и мнимые части в разных массивах.
+	// Выход может совпадать с первым входом
+#define SIMD_COMPLEX_KERNELS(TARGET) \
+	template <typename O> TARGET void complexMul(const typename O::Scalar* ar, const typename O::Scalar* ai, const typename O::Scalar* br, \
+		const typename O::Scalar* bi, typename O::Scalar* outR, typename O::Scalar* outI, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec xr = O::load(ar + i), xi = O::load(ai + i), yr = O::load(br + i), yi = O::load(bi + i); \
+			O::store(outR + i, O::sub(O::mul(xr, yr), O::mul(xi, yi))); \
+			O::store(outI + i, O::add(O::mul(xr, yi), O::mul(xi, yr))); \
+		} \
+		for (; i < n; ++i) { \
+			S xr = ar[i], xi = ai[i]; \
+			outR[i] = xr * br[i] - xi * bi[i]; \
+			outI[i] = xr * bi[i] + xi * br[i]; \
+		} \
+	} \
+	template <typename O> TARGET void complexDiv(const typename O::Scalar* ar, const typename O::Scalar* ai, const typename O::Scalar* br, \
+		const typename O::Scalar* bi, typename O::Scalar* outR, typename O::Scalar* outI, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec xr = O::load(ar + i), xi = O::load(ai + i), yr = O::load(br + i), yi = O::load(bi + i); \
+			typename O::Vec norm = O::add(O::mul(yr, yr), O::mul(yi, yi)); \
+			O::store(outR + i, O::div(O::add(O::mul(xr, yr), O::mul(xi, yi)), norm)); \
+			O::store(outI + i, O::div(O::sub(O::mul(xi, yr), O::mul(xr, yi)), norm)); \
+		} \
+		for (; i < n; ++i) { \
+			S xr = ar[i], xi = ai[i], norm = br[i] * br[i] + bi[i] * bi[i]; \
+			outR[i] = (xr * br[i] + xi * bi[i]) / norm; \
+			outI[i] = (xi * br[i] - xr * bi[i]) / norm; \
+		} \
+	} \
+	template <typename O> TARGET void complexAbs(const typename O::Scalar* re, const typename O::Scalar* im, typename O::Scalar* out, size_t n) { \
+		const size_t w = O::width; \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec r = O::load(re + i), m = O::load(im + i); \
+			O::store(out + i, O::sqrt(O::add(O::mul(r, r), O::mul(m, m)))); \
+		} \
+		for (; i < n; ++i) out[i] = std::sqrt(re[i] * re[i] + im[i] * im[i]); \
+	} \
+	/* Бабочка БПФ: t = y * w, y = x - t, x = x + t */ \
+	template <typename O> TARGET void butterfly(typename O::Scalar* xr, typename O::Scalar* xi, typename O::Scalar* yr, typename O::Scalar* yi, \
+		const typename O::Scalar* wr, const typename O::Scalar* wi, size_t n) { \
+		typedef typename O::Scalar S; \
+		const size_t w = O::width; \
+		size_t i = 0; \
+		for (; i + w <= n; i += w) { \
+			typename O::Vec ur = O::load(xr + i), ui = O::load(xi + i), vr = O::load(yr + i), vi = O::load(yi + i); \
+			typename O::Vec cr = O::load(wr + i), ci = O::load(wi + i); \
+			typename O::Vec tr = O::sub(O::mul(vr, cr), O::mul(vi, ci)), ti = O::add(O::mul(vr, ci), O::mul(vi, cr)); \
+			O::store(xr + i, O::add(ur, tr)); \
+			O::store(xi + i, O::add(ui, ti)); \
+			O::store(yr + i, O::sub(ur, tr)); \
+			O::store(yi + i, O::sub(ui, ti)); \
+		} \
+		for (; i < n; ++i) { \
+			S tr = yr[i] * wr[i] - yi[i] * wi[i], ti = yr[i] * wi[i] + yi[i] * wr[i]; \
+			yr[i] = xr[i] - tr; \
+			yi[i] = xi[i] - ti; \
+			xr[i] += tr; \
+			xi[i] += ti; \
+		} \
+	}
+
+	namespace avx512 {
+		struct F32 {
+			typedef float Scalar; typedef __m512 Vec; static const size_t width = 16;
+			SIMD_TARGET_AVX512 static Vec zero() { return _mm512_setzero_ps(); }
+			SIMD_TARGET_AVX512 static Vec set1(float s) { return _mm512_set1_ps(s); }
+			SIMD_TARGET_AVX512 static Vec load(const float* p) { return _mm512_loadu_ps(p); }
+			SIMD_TARGET_AVX512 static void store(float* p, Vec v) { _mm512_storeu_ps(p, v); }
+			SIMD_TARGET_AVX512 static Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+			SIMD_TARGET_AVX512 static Vec min(Vec a, Vec b) { return _mm512_mask_min_ps(a, __mmask16(0xFFFF), a, b); }
+			SIMD_TARGET_AVX512 static Vec max(Vec a, Vec b) { return _mm512_mask_max_ps(a, __mmask16(0xFFFF), a, b); }
+			SIMD_TARGET_AVX512 static Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+			SIMD_TARGET_AVX512 static Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+			SIMD_TARGET_AVX512 static Vec div(Vec a, Vec b) { return _mm512_div_ps(a, b); }
+			SIMD_TARGET_AVX512 static Vec sqrt(Vec a) { return _mm512_sqrt_ps(a); }
+			SIMD_TARGET_AVX512 static unsigned equalMask(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+			template <CmpOp Op> SIMD_TARGET_AVX512 static unsigned compareMask(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, floatPredicate(Op)); }
+			SIMD_TARGET_AVX512 static void compressStore(float* p, Vec v, unsigned m) { _mm512_mask_compressstoreu_ps(p, static_cast<__mmask16>(m), v); }
+		};
+		struct F64 {
+			typedef double Scalar; typedef __m512d Vec; static const size_t width = 8;
+			SIMD_TARGET_AVX512 static Vec zero() { return _mm512_setzero_pd(); }
+			SIMD_TARGET_AVX512 static Vec set1(double s) { return _mm512_set1_pd(s); }
+			SIMD_TARGET_AVX512 static Vec load(const double* p) { return _mm512_loadu_pd(p); }
+			SIMD_TARGET_AVX512 static void store(double* p, Vec v) { _mm512_storeu_pd(p, v); }
+			SIMD_TARGET_AVX512 static Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+			SIMD_TARGET_AVX512 static Vec min(Vec a, Vec b) { return _mm512_mask_min_pd(a, __mmask8(0xFF), a, b); }
+			SIMD_TARGET_AVX512 static Vec max(Vec a, Vec b) { return _mm512_mask_max_pd(a, __mmask8(0xFF), a, b); }
+			SIMD_TARGET_AVX512 static Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+			SIMD_TARGET_AVX512 static Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+			SIMD_TARGET_AVX512 static Vec div(Vec a, Vec b) { return _mm512_div_pd(a, b); }
+			SIMD_TARGET_AVX512 static Vec sqrt(Vec a) { return _mm512_sqrt_pd(a); }
+			SIMD_TARGET_AVX512 static unsigned equalMask(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+			template <CmpOp Op> SIMD_TARGET_AVX512 static unsigned compareMask(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, floatPredicate(Op)); }
+			SIMD_TARGET_AVX512 static void compressStore(double* p, Vec v, unsigned m) { _mm512_mask_compressstoreu_pd(p, static_cast<__mmask8>(m), v); }
+		};
+		struct I32 {
+			typedef int32_t Scalar; typedef __m512i Vec; static const size_t width = 16;
+			SIMD_TARGET_AVX512 static Vec zero() { return _mm512_setzero_si512(); }
+			SIMD_TARGET_AVX512 static Vec set1(int32_t s) { return _mm512_set1_epi32(s); }
+			SIMD_TARGET_AVX512 static Vec load(const int32_t* p) { return _mm512_loadu_si512(p); }
+			SIMD_TARGET_AVX512 static void store(int32_t* p, Vec v) { _mm512_storeu_si512(p, v); }
+			SIMD_TARGET_AVX512 static Vec add(Vec a, Vec b) { return _mm512_add_epi32(a, b); }
+			SIMD_TARGET_AVX512 static Vec min(Vec a, Vec b) { return _mm512_mask_min_epi32(a, __mmask16(0xFFFF), a, b); }
+			SIMD_TARGET_AVX512 static Vec max(Vec a, Vec b) { return _mm512_mask_max_epi32(a, __mmask16(0xFFFF), a, b); }
+			SIMD_TARGET_AVX512 static unsigned equalMask(Vec a, Vec b) { return _mm512_cmpeq_epi32_mask(a, b); }
+			template <CmpOp Op> SIMD_TARGET_AVX512 static unsigned compareMask(Vec a, Vec b) { return _mm512_cmp_epi32_mask(a, b, intPredicate(Op)); }
+			SIMD_TARGET_AVX512 static void compressStore(int32_t* p, Vec v, unsigned m) { _mm512_mask_compressstoreu_epi32(p, static_cast<__mmask16>(m), v); }
+		};
+
+		SIMD_REDUCTION_KERNELS(SIMD_TARGET_AVX512)
+		SIMD_TRIANGLE_KERNELS(SIMD_TARGET_AVX512)
+		SIMD_COMPLEX_KERNELS(SIMD_TARGET_AVX512)
+	}
+
+	namespace avx2 {
+		// Переставляет выбранные маской 32-битные дорожки в начало вектора
+		SIMD_TARGET_AVX2 inline __m256i compressIndices(unsigned m) {
+			return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&compressTable().lanes[m])));
+		}
+
+		// Маска первых count 32-битных дорожек: запись не выходит за последний выбранный элемент
+		SIMD_TARGET_AVX2 inline __m256i prefixMask(int count) {
+			return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		}
+
+		struct F32 {
+			typedef float Scalar; typedef __m256 Vec; static const size_t width = 8;
+			SIMD_TARGET_AVX2 static Vec zero() { return _mm256_setzero_ps(); }
+			SIMD_TARGET_AVX2 static Vec set1(float s) { return _mm256_set1_ps(s); }
+			SIMD_TARGET_AVX2 static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+			SIMD_TARGET_AVX2 static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+			SIMD_TARGET_AVX2 static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+			SIMD_TARGET_AVX2 static Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+			SIMD_TARGET_AVX2 static Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+			SIMD_TARGET_AVX2 static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+			SIMD_TARGET_AVX2 static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+			SIMD_TARGET_AVX2 static Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+			SIMD_TARGET_AVX2 static Vec sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+			SIMD_TARGET_AVX2 static unsigned equalMask(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+			template <CmpOp Op> SIMD_TARGET_AVX2 static unsigned compareMask(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, floatPredicate(Op))); }
+			SIMD_TARGET_AVX2 static void compressStore(float* p, Vec v, unsigned m) {
+				__m256 packed = _mm256_permutevar8x32_ps(v, compressIndices(m));
+				_mm256_maskstore_ps(p, prefixMask(popCount(m)), packed);
+			}
+		};
+		struct F64 {
+			typedef double Scalar; typedef __m256d Vec; static const size_t width = 4;
+			SIMD_TARGET_AVX2 static Vec zero() { return _mm256_setzero_pd(); }
+			SIMD_TARGET_AVX2 static Vec set1(double s) { return _mm256_set1_pd(s); }
+			SIMD_TARGET_AVX2 static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+			SIMD_TARGET_AVX2 static void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+			SIMD_TARGET_AVX2 static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+			SIMD_TARGET_AVX2 static Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+			SIMD_TARGET_AVX2 static Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+			SIMD_TARGET_AVX2 static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+			SIMD_TARGET_AVX2 static Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+			SIMD_TARGET_AVX2 static Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+			SIMD_TARGET_AVX2 static Vec sqrt(Vec a) { return _mm256_sqrt_pd(a); }
+			SIMD_TARGET_AVX2 static unsigned equalMask(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+			template <CmpOp Op> SIMD_TARGET_AVX2 static unsigned compareMask(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, floatPredicate(Op))); }
+			// Каждая 64-битная дорожка - пара 32-битных, маска растягивается вдвое
+			SIMD_TARGET_AVX2 static void compressStore(double* p, Vec v, unsigned m) {
+				unsigned pairs = (m & 1) * 3 | (m & 2) * 6 | (m & 4) * 12 | (m & 8) * 24;
+				__m256 packed = _mm256_permutevar8x32_ps(_mm256_castpd_ps(v), compressIndices(pairs));
+				_mm256_maskstore_pd(p, prefixMask(2 * popCount(m)), _mm256_castps_pd(packed));
+			}
+		};
+		struct I32 {
+			typedef int32_t Scalar; typedef __m256i Vec; static const size_t width = 8;
+			SIMD_TARGET_AVX2 static Vec zero() { return _mm256_setzero_si256(); }
+			SIMD_TARGET_AVX2 static Vec set1(int32_t s) { return _mm256_set1_epi32(s); }
+			SIMD_TARGET_AVX2 static Vec load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+			SIMD_TARGET_AVX2 static void store(int32_t* p, Vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+			SIMD_TARGET_AVX2 static Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+			SIMD_TARGET_AVX2 static Vec min(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+			SIMD_TARGET_AVX2 static Vec max(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+			SIMD_TARGET_AVX2 static unsigned equalMask(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+			// В AVX2 для int32 есть только == и >, остальные сравнения - через перестановку и отрицание
+			template <CmpOp Op> SIMD_TARGET_AVX2 static unsigned compareMask(Vec a, Vec b) {
+				if constexpr (Op == CmpOp::Less) return mask(_mm256_cmpgt_epi32(b, a));
+				else if constexpr (Op == CmpOp::LessEqual) return mask(_mm256_cmpgt_epi32(a, b)) ^ 0xFFu;
+				else if constexpr (Op == CmpOp::Greater) return mask(_mm256_cmpgt_epi32(a, b));
+				else if constexpr (Op == CmpOp::GreaterEqual) return mask(_mm256_cmpgt_epi32(b, a)) ^ 0xFFu;
+				else if constexpr (Op == CmpOp::Equal) return mask(_mm256_cmpeq_epi32(a, b));
+				else return mask(_mm256_cmpeq_epi32(a, b)) ^ 0xFFu;
+			}
+			SIMD_TARGET_AVX2 static unsigned mask(Vec v) { return _mm256_movemask_ps(_mm256_castsi256_ps(v)); }
+			SIMD_TARGET_AVX2 static void compressStore(int32_t* p, Vec v, unsigned m) {
+				__m256i packed = _mm256_permutevar8x32_epi32(v, compressIndices(m));
+				_mm256_maskstore_epi32(p, prefixMask(popCount(m)), packed);
+			}
+		};
+
+		SIMD_REDUCTION_KERNELS(SIMD_TARGET_AVX2)
+		SIMD_TRIANGLE_KERNELS(SIMD_TARGET_AVX2)
+		SIMD_COMPLEX_KERNELS(SIMD_TARGET_AVX2)
+
+		// Пересечение строго возрастающих массивов: блок 8 из a сравнивается со всеми
+		// 8 циклическими сдвигами блока из b, вперёд сдвигается блок с меньшим максимумом
+		SIMD_TARGET_AVX2 inline size_t intersectSorted(const int32_t* a, size_t na, const int32_t* b, size_t nb, int32_t* out) {
+			const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+			size_t i = 0, j = 0, count = 0;
+			while (i + 8 <= na && j + 8 <= nb) {
+				__m256i va = I32::load(a + i), vb = I32::load(b + j);
+				__m256i hit = _mm256_cmpeq_epi32(va, vb);
+				for (int r = 1; r < 8; ++r) {
+					vb = _mm256_permutevar8x32_epi32(vb, rotate);
+					hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(va, vb));
+				}
+				unsigned m = I32::mask(hit);
+				I32::compressStore(out + count, va, m);
+				count += popCount(m);
+				int32_t aMax = a[i + 7], bMax = b[j + 7];
+				if (aMax <= bMax) i += 8;
+				if (bMax <= aMax) j += 8;
+			}
+			while (i < na && j < nb) {
+				if (a[i] < b[j]) ++i;
+				else if (b[j] < a[i]) ++j;
+				else { out[count++] = a[i]; ++i; ++j; }
+			}
+			return count;
+		}
+	}
+
+	namespace sse {
+		// В SSE2 нет перестановки по маске: выбранные дорожки переписываются по одной
+		template <typename S, typename V, typename Store>
+		void compressLanes(S* p, V v, unsigned m, Store store) {
+			S lanes[sizeof(V) / sizeof(S)];
+			store(lanes, v);
+			for (; m; m &= m - 1) *p++ = lanes[lowestBit(m)];
+		}
+
+		struct F32 {
+			typedef float Scalar; typedef __m128 Vec; static const size_t width = 4;
+			static Vec zero() { return _mm_setzero_ps(); }
+			static Vec set1(float s) { return _mm_set1_ps(s); }
+			static Vec load(const float* p) { return _mm_loadu_ps(p); }
+			static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+			static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+			static Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+			static Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+			static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+			static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+			static Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+			static Vec sqrt(Vec a) { return _mm_sqrt_ps(a); }
+			static unsigned equalMask(Vec a, Vec b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+			template <CmpOp Op> static unsigned compareMask(Vec a, Vec b) {
+				if constexpr (Op == CmpOp::Less) return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+				else if constexpr (Op == CmpOp::LessEqual) return _mm_movemask_ps(_mm_cmple_ps(a, b));
+				else if constexpr (Op == CmpOp::Greater) return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+				else if constexpr (Op == CmpOp::GreaterEqual) return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+				else if constexpr (Op == CmpOp::Equal) return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+				else return _mm_movemask_ps(_mm_cmpneq_ps(a, b));
+			}
+			static void compressStore(float* p, Vec v, unsigned m) { compressLanes(p, v, m, store); }
+		};
+		struct F64 {
+			typedef double Scalar; typedef __m128d Vec; static const size_t width = 2;
+			static Vec zero() { return _mm_setzero_pd(); }
+			static Vec set1(double s) { return _mm_set1_pd(s); }
+			static Vec load(const double* p) { return _mm_loadu_pd(p); }
+			static void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+			static Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+			static Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+			static Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+			static Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+			static Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+			static Vec div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+			static Vec sqrt(Vec a) { return _mm_sqrt_pd(a); }
+			static unsigned equalMask(Vec a, Vec b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+			template <CmpOp Op> static unsigned compareMask(Vec a, Vec b) {
+				if constexpr (Op == CmpOp::Less) return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+				else if constexpr (Op == CmpOp::LessEqual) return _mm_movemask_pd(_mm_cmple_pd(a, b));
+				else if constexpr (Op == CmpOp::Greater) return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+				else if constexpr (Op == CmpOp::GreaterEqual) return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+				else if constexpr (Op == CmpOp::Equal) return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+				else return _mm_movemask_pd(_mm_cmpneq_pd(a, b));
+			}
+			static void compressStore(double* p, Vec v, unsigned m) { compressLanes(p, v, m, store); }
+		};
+		// В SSE2 нет min/max для int32, они собираются из сравнения и масок
+		struct I32 {
+			typedef int32_t Scalar; typedef __m128i Vec; static const size_t width = 4;
+			static Vec zero() { return _mm_setzero_si128(); }
+			static Vec set1(int32_t s) { return _mm_set1_epi32(s); }
+			static Vec load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+			static void store(int32_t* p, Vec v) { _mm_storeu_si128((__m128i*)p, v); }
+			static Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+			static Vec min(Vec a, Vec b) {
+				__m128i lt = _mm_cmplt_epi32(a, b);
+				return _mm_or_si128(_mm_and_si128(lt, a), _mm_andnot_si128(lt, b));
+			}
+			static Vec max(Vec a, Vec b) {
+				__m128i gt = _mm_cmpgt_epi32(a, b);
+				return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+			}
+			static unsigned equalMask(Vec a, Vec b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+			template <CmpOp Op> static unsigned compareMask(Vec a, Vec b) {
+				if constexpr (Op == CmpOp::Less) return mask(_mm_cmplt_epi32(a, b));
+				else if constexpr (Op == CmpOp::LessEqual) return mask(_mm_cmpgt_epi32(a, b)) ^ 0xFu;
+				else if constexpr (Op == CmpOp::Greater) return mask(_mm_cmpgt_epi32(a, b));
+				else if constexpr (Op == CmpOp::GreaterEqual) return mask(_mm_cmplt_epi32(a, b)) ^ 0xFu;
+				else if constexpr (Op == CmpOp::Equal) return mask(_mm_cmpeq_epi32(a, b));
+				else return mask(_mm_cmpeq_epi32(a, b)) ^ 0xFu;
+			}
+			static unsigned mask(Vec v) { return _mm_movemask_ps(_mm_castsi128_ps(v)); }
+			static void compressStore(int32_t* p, Vec v, unsigned m) { compressLanes(p, v, m, store); }
+		};
+
+		SIMD_REDUCTION_KERNELS()
+		SIMD_TRIANGLE_KERNELS()
+		SIMD_COMPLEX_KERNELS()
+
+		inline size_t intersectSorted(const int32_t* a, size_t na, const int32_t* b, size_t nb, int32_t* out) {
+			size_t i = 0, j = 0, count = 0;
+			while (i + 4 <= na && j + 4 <= nb) {
+				__m128i va = I32::load(a + i), vb = I32::load(b + j);
+				__m128i hit = _mm_cmpeq_epi32(va, vb);
+				for (int r = 1; r < 4; ++r) {
+					vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+					hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, vb));
+				}
+				unsigned m = I32::mask(hit);
+				I32::compressStore(out + count, va, m);
+				count += popCount(m);
+				int32_t aMax = a[i + 3], bMax = b[j + 3];
+				if (aMax <= bMax) i += 4;
+				if (bMax <= aMax) j += 4;
+			}
+			while (i < na && j < nb) {
+				if (a[i] < b[j]) ++i;
+				else if (b[j] < a[i]) ++j;
+				else { out[count++] = a[i]; ++i; ++j; }
+			}
+			return count;
+		}
+	}
+
+#undef SIMD_REDUCTION_KERNELS
+#undef SIMD_TRIANGLE_KERNELS
+#undef SIMD_COMPLEX_KERNELS
+
+	template <typename T> struct Lanes;
+	template <> struct Lanes<float> { typedef avx512::F32 Avx512; typedef avx2::F32 Avx2; typedef sse::F32 Sse; };
+	template <> struct Lanes<double> { typedef avx512::F64 Avx512; typedef avx2::F64 Avx2; typedef sse::F64 Sse; };
+	template <> struct Lanes<int32_t> { typedef avx512::I32 Avx512; typedef avx2::I32 Avx2; typedef sse::I32 Sse; };
+#endif
+
+	// Редукции для float, double и int32: AVX-512, AVX2 или SSE2 по возможностям процессора.
+	// Порядок сложения меняется, поэтому сумма float/double может отличаться от скалярной в младших битах
+	template <typename T>
+	T sum(const T* a, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx512f) return avx512::sum<typename Lanes<T>::Avx512>(a, n);
+			if (cpu().avx2) return avx2::sum<typename Lanes<T>::Avx2>(a, n);
+			return sse::sum<typename Lanes<T>::Sse>(a, n);
+		}
+#endif
+		T result = 0;
+		for (size_t i = 0; i < n; ++i) result += a[i];
+		return result;
+	}
+
+	// n > 0
+	template <typename T>
+	T minimum(const T* a, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx512f) return avx512::minimum<typename Lanes<T>::Avx512>(a, n);
+			if (cpu().avx2) return avx2::minimum<typename Lanes<T>::Avx2>(a, n);
+			return sse::minimum<typename Lanes<T>::Sse>(a, n);
+		}
+#endif
+		T result = a[0];
+		for (size_t i = 1; i < n; ++i) if (a[i] < result) result = a[i];
+		return result;
+	}
+
+	// Второй по величине элемент с учётом повторов, n >= 2
+	template <typename T>
+	T secondMax(const T* a, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx512f) return avx512::secondMax<typename Lanes<T>::Avx512>(a, n);
+			if (cpu().avx2) return avx2::secondMax<typename Lanes<T>::Avx2>(a, n);
+			return sse::secondMax<typename Lanes<T>::Sse>(a, n);
+		}
+#endif
+		T first = a[0] > a[1] ? a[0] : a[1];
+		T second = a[0] > a[1] ? a[1] : a[0];
+		for (size_t i = 2; i < n; ++i) pushTopTwo(a[i], first, second);
+		return second;
+	}
+
+	// Индекс первого равного value или n
+	template <typename T>
+	size_t find(const T* a, size_t n, const T& value) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx512f) return avx512::find<typename Lanes<T>::Avx512>(a, n, value);
+			if (cpu().avx2) return avx2::find<typename Lanes<T>::Avx2>(a, n, value);
+			return sse::find<typename Lanes<T>::Sse>(a, n, value);
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) if (a[i] == value) return i;
+		return n;
+	}
+
+	template <CmpOp Op, typename T>
+	size_t compressWith(const T* a, size_t n, const T& value, T* out) {
+#ifdef SIMD_X86
+		if constexpr (isVectorizable<T>()) {
+			if (cpu().avx512f) return avx512::compress<typename Lanes<T>::Avx512, Op>(a, n, value, out);
+			if (cpu().avx2) return avx2::compress<typename Lanes<T>::Avx2, Op>(a, n, value, out);
+			return sse::compress<typename Lanes<T>::Sse, Op>(a, n, value, out);
+		}
+#endif
+		size_t count = 0;
+		for (size_t i = 0; i < n; ++i) if (compareScalar<Op>(a[i], value)) out[count++] = a[i];
+		return count;
+	}
+
+	// Копирует в out подряд элементы, для которых pred истинен; возвращает их число.
+	// За out пишется ровно столько элементов, сколько выбрано
+	template <typename T>
+	size_t compress(const T* a, size_t n, const Compare<T>& pred, T* out) {
+		switch (pred.op) {
+		case CmpOp::Less: return compressWith<CmpOp::Less>(a, n, pred.value, out);
+		case CmpOp::LessEqual: return compressWith<CmpOp::LessEqual>(a, n, pred.value, out);
+		case CmpOp::Greater: return compressWith<CmpOp::Greater>(a, n, pred.value, out);
+		case CmpOp::GreaterEqual: return compressWith<CmpOp::GreaterEqual>(a, n, pred.value, out);
+		case CmpOp::Equal: return compressWith<CmpOp::Equal>(a, n, pred.value, out);
+		default: return compressWith<CmpOp::NotEqual>(a, n, pred.value, out);
+		}
+	}
+
+	// Общие элементы строго возрастающих a и b; в out должно быть место под min(na, nb)
+	inline size_t intersectSorted(const int32_t* a, size_t na, const int32_t* b, size_t nb, int32_t* out) {
+#ifdef SIMD_X86
+		if (cpu().avx2) return avx2::intersectSorted(a, na, b, nb, out);
+		return sse::intersectSorted(a, na, b, nb, out);
+#else
+		size_t i = 0, j = 0, count = 0;
+		while (i < na && j < nb) {
+			if (a[i] < b[j]) ++i;
+			else if (b[j] < a[i]) ++j;
+			else { out[count++] = a[i]; ++i; ++j; }
+		}
+		return count;
+#endif
+	}
+
+	// Группа управляющих байтов хеш-таблицы, проверяемая одной SSE2-инструкцией
+	const size_t groupWidth = 16;
+
+	// Биты байтов группы, равных tag
+	inline unsigned groupMatch(const uint8_t* ctrl, uint8_t tag) {
+#ifdef SIMD_X86
+		__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+		unsigned mask = 0;
+		for (size_t i = 0; i < groupWidth; ++i) if (ctrl[i] == tag) mask |= 1u << i;
+		return mask;
+#endif
+	}
+
+	// Биты байтов группы со старшим единичным битом
+	inline unsigned groupHighBits(const uint8_t* ctrl) {
+#ifdef SIMD_X86
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))));
+#else
+		unsigned mask = 0;
+		for (size_t i = 0; i < groupWidth; ++i) if (ctrl[i] & 0x80) mask |= 1u << i;
+		return mask;
+#endif
+	}
+
+	// Пачка треугольников: v - шесть массивов ax, ay, bx, by, cx, cy длины n.
+	// Векторно для float и double, для остальных типов - скалярно
+	template <typename T>
+	void triangleArea(const T* const* v, T* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::triangleArea<typename Lanes<T>::Avx512>(v, out, n); return; }
+			if (cpu().avx2) { avx2::triangleArea<typename Lanes<T>::Avx2>(v, out, n); return; }
+			sse::triangleArea<typename Lanes<T>::Sse>(v, out, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			T cross = (v[2][i] - v[0][i]) * (v[5][i] - v[1][i]) - (v[4][i] - v[0][i]) * (v[3][i] - v[1][i]);
+			out[i] = (cross < 0 ? -cross : cross) / 2;
+		}
+	}
+
+	template <typename T>
+	void triangleCentroid(const T* const* v, T* outX, T* outY, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::triangleCentroid<typename Lanes<T>::Avx512>(v, outX, outY, n); return; }
+			if (cpu().avx2) { avx2::triangleCentroid<typename Lanes<T>::Avx2>(v, outX, outY, n); return; }
+			sse::triangleCentroid<typename Lanes<T>::Sse>(v, outX, outY, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			outX[i] = (v[0][i] + v[2][i] + v[4][i]) / 3;
+			outY[i] = (v[1][i] + v[3][i] + v[5][i]) / 3;
+		}
+	}
+
+	// out - четыре массива minX, minY, maxX, maxY
+	template <typename T>
+	void triangleBounds(const T* const* v, T* const* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::triangleBounds<typename Lanes<T>::Avx512>(v, out, n); return; }
+			if (cpu().avx2) { avx2::triangleBounds<typename Lanes<T>::Avx2>(v, out, n); return; }
+			sse::triangleBounds<typename Lanes<T>::Sse>(v, out, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			out[0][i] = std::min(std::min(v[0][i], v[2][i]), v[4][i]);
+			out[1][i] = std::min(std::min(v[1][i], v[3][i]), v[5][i]);
+			out[2][i] = std::max(std::max(v[0][i], v[2][i]), v[4][i]);
+			out[3][i] = std::max(std::max(v[1][i], v[3][i]), v[5][i]);
+		}
+	}
+
+	// out[i] = 1, если точка (px, py) лежит в i-м треугольнике или на его границе
+	template <typename T>
+	void triangleContains(const T* const* v, T px, T py, uint8_t* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::triangleContains<typename Lanes<T>::Avx512>(v, px, py, out, n); return; }
+			if (cpu().avx2) { avx2::triangleContains<typename Lanes<T>::Avx2>(v, px, py, out, n); return; }
+			sse::triangleContains<typename Lanes<T>::Sse>(v, px, py, out, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			T d1 = (v[2][i] - v[0][i]) * (py - v[1][i]) - (v[3][i] - v[1][i]) * (px - v[0][i]);
+			T d2 = (v[4][i] - v[2][i]) * (py - v[3][i]) - (v[5][i] - v[3][i]) * (px - v[2][i]);
+			T d3 = (v[0][i] - v[4][i]) * (py - v[5][i]) - (v[1][i] - v[5][i]) * (px - v[4][i]);
+			bool negative = d1 < 0 || d2 < 0 || d3 < 0, positive = d1 > 0 || d2 > 0 || d3 > 0;
+			out[i] = static_cast<uint8_t>(negative || positive ? !(negative && positive) : segmentHit(v, i, px, py));
+		}
+	}
+
+	// Поэлементные операции над комплексными массивами в раздельном виде (re, im).
+	// Векторно для float и double; выход может совпадать с первым входом
+	template <typename T>
+	void complexMul(const T* ar, const T* ai, const T* br, const T* bi, T* outR, T* outI, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::complexMul<typename Lanes<T>::Avx512>(ar, ai, br, bi, outR, outI, n); return; }
+			if (cpu().avx2) { avx2::complexMul<typename Lanes<T>::Avx2>(ar, ai, br, bi, outR, outI, n); return; }
+			sse::complexMul<typename Lanes<T>::Sse>(ar, ai, br, bi, outR, outI, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			T xr = ar[i], xi = ai[i];
+			outR[i] = xr * br[i] - xi * bi[i];
+			outI[i] = xr * bi[i] + xi * br[i];
+		}
+	}
+
+	// Деление на ноль не проверяется: для float/double получаются inf и NaN
+	template <typename T>
+	void complexDiv(const T* ar, const T* ai, const T* br, const T* bi, T* outR, T* outI, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::complexDiv<typename Lanes<T>::Avx512>(ar, ai, br, bi, outR, outI, n); return; }
+			if (cpu().avx2) { avx2::complexDiv<typename Lanes<T>::Avx2>(ar, ai, br, bi, outR, outI, n); return; }
+			sse::complexDiv<typename Lanes<T>::Sse>(ar, ai, br, bi, outR, outI, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			T xr = ar[i], xi = ai[i], norm = br[i] * br[i] + bi[i] * bi[i];
+			outR[i] = (xr * br[i] + xi * bi[i]) / norm;
+			outI[i] = (xi * br[i] - xr * bi[i]) / norm;
+		}
+	}
+
+	// Модуль без защиты от переполнения квадратов, в отличие от std::hypot
+	template <typename T>
+	void complexAbs(const T* re, const T* im, T* out, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::complexAbs<typename Lanes<T>::Avx512>(re, im, out, n); return; }
+			if (cpu().avx2) { avx2::complexAbs<typename Lanes<T>::Avx2>(re, im, out, n); return; }
+			sse::complexAbs<typename Lanes<T>::Sse>(re, im, out, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) out[i] = static_cast<T>(std::sqrt(re[i] * re[i] + im[i] * im[i]));
+	}
+
+	// n бабочек подряд: x и y - половины блока, w - поворотные множители
+	template <typename T>
+	void butterfly(T* xr, T* xi, T* yr, T* yi, const T* wr, const T* wi, size_t n) {
+#ifdef SIMD_X86
+		if constexpr (std::is_floating_point<T>::value && isVectorizable<T>()) {
+			if (cpu().avx512f) { avx512::butterfly<typename Lanes<T>::Avx512>(xr, xi, yr, yi, wr, wi, n); return; }
+			if (cpu().avx2) { avx2::butterfly<typename Lanes<T>::Avx2>(xr, xi, yr, yi, wr, wi, n); return; }
+			sse::butterfly<typename Lanes<T>::Sse>(xr, xi, yr, yi, wr, wi, n);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < n; ++i) {
+			T tr = yr[i] * wr[i] - yi[i] * wi[i], ti = yr[i] * wi[i] + yi[i] * wr[i];
+			yr[i] = xr[i] - tr;
+			yi[i] = xi[i] - ti;
+			xr[i] += tr;
+			xi[i] += ti;
+		}
+	}
+}
@@ -0,0 +1,445 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Parallel.h"
+
+using namespace std;
+
+// Способ сортировки для sorting::sort
+enum class SortPolicy {
+	Auto,      // выбирается по типу, размеру и числу ядер
+	Introsort, // pdqsort: быстрая сортировка с откатом на пирамидальную
+	Radix,     // поразрядная LSD для целых и float/double, иначе Introsort
+	Parallel   // выборочная (sample) сортировка по всем ядрам
+};
+
+namespace sorting {
+	const ptrdiff_t insertionSortThreshold = 24;
+	const ptrdiff_t nintherThreshold = 128;
+	const size_t partialInsertionSortLimit = 8;
+	const ptrdiff_t radixThreshold = 256;
+	const ptrdiff_t parallelThreshold = 1 << 17;
+
+	template <typename It, typename Cmp>
+	void insertionSort(It begin, It end, Cmp cmp) {
+		using T = typename iterator_traits<It>::value_type;
+		if (begin == end) return;
+		for (It cur = begin + 1; cur != end; ++cur) {
+			It sift = cur, prev = cur - 1;
+			if (cmp(*sift, *prev)) {
+				T tmp = move(*sift);
+				do { *sift-- = move(*prev); } while (sift != begin && cmp(tmp, *--prev));
+				*sift = move(tmp);
+			}
+		}
+	}
+
+	// Слева от begin гарантированно лежит элемент не больше любого из диапазона
+	template <typename It, typename Cmp>
+	void unguardedInsertionSort(It begin, It end, Cmp cmp) {
+		using T = typename iterator_traits<It>::value_type;
+		if (begin == end) return;
+		for (It cur = begin + 1; cur != end; ++cur) {
+			It sift = cur, prev = cur - 1;
+			if (cmp(*sift, *prev)) {
+				T tmp = move(*sift);
+				do { *sift-- = move(*prev); } while (cmp(tmp, *--prev));
+				*sift = move(tmp);
+			}
+		}
+	}
+
+	// Сдаётся, если пришлось сдвинуть больше partialInsertionSortLimit элементов
+	template <typename It, typename Cmp>
+	bool partialInsertionSort(It begin, It end, Cmp cmp) {
+		using T = typename iterator_traits<It>::value_type;
+		if (begin == end) return true;
+		size_t moved = 0;
+		for (It cur = begin + 1; cur != end; ++cur) {
+			It sift = cur, prev = cur - 1;
+			if (cmp(*sift, *prev)) {
+				T tmp = move(*sift);
+				do { *sift-- = move(*prev); } while (sift != begin && cmp(tmp, *--prev));
+				*sift = move(tmp);
+				moved += static_cast<size_t>(cur - sift);
+			}
+			if (moved > partialInsertionSortLimit) return false;
+		}
+		return true;
+	}
+
+	template <typename It, typename Cmp>
+	void sort2(It a, It b, Cmp cmp) {
+		if (cmp(*b, *a)) iter_swap(a, b);
+	}
+
+	template <typename It, typename Cmp>
+	void sort3(It a, It b, It c, Cmp cmp) {
+		sort2(a, b, cmp);
+		sort2(b, c, cmp);
+		sort2(a, b, cmp);
+	}
+
+	// Опорный элемент в *begin; равные ему уходят вправо.
+	// Второе значение пары - диапазон уже был разбит и обменов не понадобилось
+	template <typename It, typename Cmp>
+	pair<It, bool> partitionRight(It begin, It end, Cmp cmp) {
+		using T = typename iterator_traits<It>::value_type;
+		T pivot(move(*begin));
+		It first = begin, last = end;
+
+		while (cmp(*++first, pivot));
+		if (first - 1 == begin) while (first < last && !cmp(*--last, pivot));
+		else while (!cmp(*--last, pivot));
+
+		bool alreadyPartitioned = first >= last;
+		while (first < last) {
+			iter_swap(first, last);
+			while (cmp(*++first, pivot));
+			while (!cmp(*--last, pivot));
+		}
+
+		It pivotPos = first - 1;
+		*begin = move(*pivotPos);
+		*pivotPos = move(pivot);
+		return make_pair(pivotPos, alreadyPartitioned);
+	}
+
+	// Равные опорному уходят влево: так серия одинаковых ключей снимается за один проход
+	template <typename It, typename Cmp>
+	It partitionLeft(It begin, It end, Cmp cmp) {
+		using T = typename iterator_traits<It>::value_type;
+		T pivot(move(*begin));
+		It first = begin, last = end;
+
+		while (cmp(pivot, *--last));
+		if (last + 1 == end) while (first < last && !cmp(pivot, *++first));
+		else while (!cmp(pivot, *++first));
+
+		while (first < last) {
+			iter_swap(first, last);
+			while (cmp(pivot, *--last));
+			while (!cmp(pivot, *++first));
+		}
+
+		It pivotPos = last;
+		*begin = move(*pivotPos);
+		*pivotPos = move(pivot);
+		return pivotPos;
+	}
+
+	template <typename It, typename Cmp>
+	void pdqsortLoop(It begin, It end, Cmp cmp, int badAllowed, bool leftmost) {
+		while (true) {
+			ptrdiff_t size = end - begin;
+			if (size < insertionSortThreshold) {
+				if (leftmost) insertionSort(begin, end, cmp);
+				else unguardedInsertionSort(begin, end, cmp);
+				return;
+			}
+
+			ptrdiff_t half = size / 2;
+			if (size > nintherThreshold) {
+				sort3(begin, begin + half, end - 1, cmp);
+				sort3(begin + 1, begin + (half - 1), end - 2, cmp);
+				sort3(begin + 2, begin + (half + 1), end - 3, cmp);
+				sort3(begin + (half - 1), begin + half, begin + (half + 1), cmp);
+				iter_swap(begin, begin + half);
+			}
+			else sort3(begin + half, begin, end - 1, cmp);
+
+			// Опорный равен элементу слева от диапазона - все равные ему сразу на месте
+			if (!leftmost && !cmp(*(begin - 1), *begin)) {
+				begin = partitionLeft(begin, end, cmp) + 1;
+				continue;
+			}
+
+			pair<It, bool> part = partitionRight(begin, end, cmp);
+			It pivotPos = part.first;
+			ptrdiff_t leftSize = pivotPos - begin;
+			ptrdiff_t rightSize = end - (pivotPos + 1);
+
+			if (leftSize < size / 8 || rightSize < size / 8) {
+				if (--badAllowed == 0) {
+					make_heap(begin, end, cmp);
+					sort_heap(begin, end, cmp);
+					return;
+				}
+				// Перемешиваем, чтобы сломать неудачный для медианы шаблон
+				if (leftSize >= insertionSortThreshold) {
+					iter_swap(begin, begin + leftSize / 4);
+					iter_swap(pivotPos - 1, pivotPos - leftSize / 4);
+					if (leftSize > nintherThreshold) {
+						iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+						iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+						iter_swap(pivotPos - 2, pivotPos - (leftSize / 4 + 1));
+						iter_swap(pivotPos - 3, pivotPos - (leftSize / 4 + 2));
+					}
+				}
+				if (rightSize >= insertionSortThreshold) {
+					iter_swap(pivotPos + 1, pivotPos + (1 + rightSize / 4));
+					iter_swap(end - 1, end - rightSize / 4);
+					if (rightSize > nintherThreshold) {
+						iter_swap(pivotPos + 2, pivotPos + (2 + rightSize / 4));
+						iter_swap(pivotPos + 3, pivotPos + (3 + rightSize / 4));
+						iter_swap(end - 2, end - (1 + rightSize / 4));
+						iter_swap(end - 3, end - (2 + rightSize / 4));
+					}
+				}
+			}
+			// Разбиение без обменов - вероятно, вход почти упорядочен
+			else if (part.second && partialInsertionSort(begin, pivotPos, cmp)
+				&& partialInsertionSort(pivotPos + 1, end, cmp)) return;
+
+			pdqsortLoop(begin, pivotPos, cmp, badAllowed, leftmost);
+			begin = pivotPos + 1;
+			leftmost = false;
+		}
+	}
+
+	template <typename It, typename Cmp>
+	void introsort(It first, It last, Cmp cmp) {
+		ptrdiff_t n = last - first;
+		if (n < 2) return;
+		int log2n = 0;
+		while (n >>= 1) ++log2n;
+		pdqsortLoop(first, last, cmp, log2n, true);
+	}
+
+	// Беззнаковый ключ, порядок которого совпадает с порядком исходных значений
+	template <typename T, typename = void>
+	struct RadixKey {
+		static const bool supported = false;
+	};
+
+	template <typename T>
+	struct RadixKey<T, typename enable_if<is_integral<T>::value && !is_same<T, bool>::value>::type> {
+		static const bool supported = true;
+		using type = typename make_unsigned<T>::type;
+		static type get(T v) {
+			type bits = static_cast<type>(v);
+			if (is_signed<T>::value) bits ^= type(1) << (sizeof(T) * 8 - 1);
+			return bits;
+		}
+	};
+
+	template <typename T>
+	struct RadixKey<T, typename enable_if<is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8)>::type> {
+		static const bool supported = true;
+		using type = typename conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+		static type get(T v) {
+			type bits;
+			memcpy(&bits, &v, sizeof(T));
+			const type sign = type(1) << (sizeof(T) * 8 - 1);
+			return (bits & sign) ? ~bits : (bits | sign);
+		}
+	};
+
+	// Поразрядная сортировка подходит только для естественного порядка "меньше"
+	template <typename T, typename Cmp>
+	struct RadixSortable {
+		static const bool value = RadixKey<T>::supported
+			&& (is_same<Cmp, less<T>>::value || is_same<Cmp, less<>>::value);
+	};
+
+	// LSD по байтам: все гистограммы за один проход, байты с одним значением пропускаются
+	template <typename It>
+	void radixSort(It first, It last) {
+		using T = typename iterator_traits<It>::value_type;
+		using Key = RadixKey<T>;
+		const size_t n = static_cast<size_t>(last - first);
+		const int passes = sizeof(T);
+		if (n < 2) return;
+
+		vector<size_t> counts(passes * 256, 0);
+		for (size_t i = 0; i < n; ++i) {
+			typename Key::type k = Key::get(first[i]);
+			for (int p = 0; p < passes; ++p) ++counts[p * 256 + ((k >> (8 * p)) & 0xFF)];
+		}
+
+		vector<T> buffer(n);
+		bool inBuffer = false;
+		auto scatter = [&](auto src, auto dst, int p) {
+			size_t* c = &counts[p * 256];
+			size_t sum = 0;
+			for (int b = 0; b < 256; ++b) {
+				size_t cnt = c[b];
+				c[b] = sum;
+				sum += cnt;
+			}
+			for (size_t i = 0; i < n; ++i) {
+				typename Key::type k = Key::get(src[i]);
+				dst[c[(k >> (8 * p)) & 0xFF]++] = src[i];
+			}
+		};
+
+		for (int p = 0; p < passes; ++p) {
+			const size_t* c = &counts[p * 256];
+			if (*max_element(c, c + 256) == n) continue;
+			if (inBuffer) scatter(buffer.begin(), first, p);
+			else scatter(first, buffer.begin(), p);
+			inBuffer = !inBuffer;
+		}
+		if (inBuffer) copy(buffer.begin(), buffer.end(), first);
+	}
+
+	// Последовательный выбор: поразрядная для чисел, иначе introsort
+	template <typename It, typename Cmp>
+	void sequentialSort(It first, It last, Cmp cmp) {
+		using T = typename iterator_traits<It>::value_type;
+		if constexpr (RadixSortable<T, Cmp>::value) {
+			if (last - first >= radixThreshold) {
+				radixSort(first, last);
+				return;
+			}
+		}
+		introsort(first, last, cmp);
+	}
+
+	// Выборочная сортировка: по выборке ставятся разделители, элементы раскладываются
+	// по корзинам параллельно, корзины сортируются независимо через sortRange. Элементы, равные
+	// разделителю, попадают в отдельную корзину и не сортируются вовсе. Раскладка сохраняет
+	// исходный порядок, так что с устойчивым sortRange устойчива и вся сортировка
+	template <typename It, typename Cmp, typename SortRange>
+	void sampleSortWith(It first, It last, Cmp cmp, int threads, SortRange sortRange) {
+		using T = typename iterator_traits<It>::value_type;
+		const long long n = last - first;
+		if (threads <= 0) threads = hardwareThreads();
+		threads = min(threads, 256);
+		if (threads <= 1 || n < parallelThreshold) {
+			sortRange(first, last);
+			return;
+		}
+
+		const int oversample = 32;
+		const int splitCount = threads - 1;
+		vector<T> samples;
+		samples.reserve(static_cast<size_t>(threads * oversample));
+		for (long long s = 0; s < threads * oversample; ++s) samples.push_back(first[n * s / (threads * oversample)]);
+		introsort(samples.begin(), samples.end(), cmp);
+		vector<T> splitters;
+		splitters.reserve(static_cast<size_t>(splitCount));
+		for (int s = 1; s <= splitCount; ++s) splitters.push_back(samples[s * oversample]);
+
+		// Корзина 2j - строго между разделителями j-1 и j, 2j+1 - равные разделителю j
+		const int buckets = 2 * splitCount + 1;
+		vector<uint16_t> bucketOf(static_cast<size_t>(n));
+		vector<long long> counts(static_cast<size_t>(threads) * buckets, 0);
+		vector<long long> bounds(static_cast<size_t>(threads + 1));
+		for (int c = 0; c <= threads; ++c) bounds[c] = n * c / threads;
+
+		parallelFor(0, threads, 1, [&](long long lo, long long hi) {
+			for (long long c = lo; c < hi; ++c) {
+				long long* cnt = &counts[c * buckets];
+				for (long long i = bounds[c]; i < bounds[c + 1]; ++i) {
+					const T& v = first[i];
+					int j = static_cast<int>(lower_bound(splitters.begin(), splitters.end(), v, cmp) - splitters.begin());
+					int b = (j < splitCount && !cmp(v, splitters[j])) ? 2 * j + 1 : 2 * j;
+					bucketOf[i] = static_cast<uint16_t>(b);
+					++cnt[b];
+				}
+			}
+		}, threads);
+
+		// Смещения: корзина за корзиной, внутри корзины - кусок за куском
+		vector<long long> bucketStart(static_cast<size_t>(buckets + 1));
+		long long sum = 0;
+		for (int b = 0; b < buckets; ++b) {
+			bucketStart[b] = sum;
+			for (int c = 0; c < threads; ++c) {
+				long long cnt = counts[c * buckets + b];
+				counts[c * buckets + b] = sum;
+				sum += cnt;
+			}
+		}
+		bucketStart[buckets] = n;
+
+		allocator<T> alloc;
+		T* buffer = alloc.allocate(static_cast<size_t>(n));
+		parallelFor(0, threads, 1, [&](long long lo, long long hi) {
+			for (long long c = lo; c < hi; ++c) {
+				long long* pos = &counts[c * buckets];
+				for (long long i = bounds[c]; i < bounds[c + 1]; ++i)
+					::new (static_cast<void*>(buffer + pos[bucketOf[i]]++)) T(move(first[i]));
+			}
+		}, threads);
+
+		parallelFor(0, buckets, 1, [&](long long lo, long long hi) {
+			for (long long b = lo; b < hi; ++b) {
+				T* from = buffer + bucketStart[b];
+				T* to = buffer + bucketStart[b + 1];
+				if (b % 2 == 0) sortRange(from, to);
+				It out = first + bucketStart[b];
+				for (T* p = from; p != to; ++p, ++out) {
+					*out = move(*p);
+					p->~T();
+				}
+			}
+		}, threads);
+		alloc.deallocate(buffer, static_cast<size_t>(n));
+	}
+
+	template <typename It, typename Cmp>
+	void sampleSort(It first, It last, Cmp cmp, int threads = 0) {
+		sampleSortWith(first, last, cmp, threads, [&](auto from, auto to) { sequentialSort(from, to, cmp); });
+	}
+
+	// Устойчивая параллельная сортировка: равные элементы остаются в исходном порядке
+	template <typename It, typename Cmp>
+	void stableSampleSort(It first, It last, Cmp cmp, int threads = 0) {
+		sampleSortWith(first, last, cmp, threads, [&](auto from, auto to) { stable_sort(from, to, cmp); });
+	}
+
+	template <typename It, typename Cmp>
+	void sort(It first, It last, Cmp cmp, SortPolicy policy = SortPolicy::Auto) {
+		using T = typename iterator_traits<It>::value_type;
+		switch (policy) {
+		case SortPolicy::Introsort:
+			introsort(first, last, cmp);
+			return;
+		case SortPolicy::Radix:
+			if constexpr (RadixSortable<T, Cmp>::value) radixSort(first, last);
+			else introsort(first, last, cmp);
+			return;
+		case SortPolicy::Parallel:
+			sampleSort(first, last, cmp);
+			return;
+		case SortPolicy::Auto:
+			break;
+		}
+
+		if (last - first < 2) return;
+		// Упорядоченный и обратный вход распознаются за один проход
+		if (is_sorted(first, last, cmp)) return;
+		if (is_sorted(first, last, [&](const T& a, const T& b) { return cmp(b, a); })) {
+			reverse(first, last);
+			return;
+		}
+		if (hardwareThreads() > 1 && last - first >= parallelThreshold) sampleSort(first, last, cmp);
+		else sequentialSort(first, last, cmp);
+	}
+
+	template <typename It>
+	void sort(It first, It last, SortPolicy policy = SortPolicy::Auto) {
+		sorting::sort(first, last, less<typename iterator_traits<It>::value_type>(), policy);
+	}
+
+	// Любой контейнер с begin()/end(), в том числе обычный массив
+	template <typename Range>
+	void sort(Range& range, SortPolicy policy = SortPolicy::Auto) {
+		sorting::sort(std::begin(range), std::end(range), policy);
+	}
+
+	template <typename Range, typename Cmp>
+	void sort(Range& range, Cmp cmp, SortPolicy policy = SortPolicy::Auto) {
+		sorting::sort(std::begin(range), std::end(range), cmp, policy);
+	}
+}
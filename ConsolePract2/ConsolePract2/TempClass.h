@@ -1,355 +1,2665 @@
-#include <iostream>
-#include <vector>
-#include <stdexcept> 
-#include <algorithm> 
-#include <list>
-#include <map>
-#include <set>
-
-using namespace std;
-
-template <typename T, typename D>
-class Pair {
-public:
-	Pair(T first, D second) : first{ first }, second{ second } {}
-	
-	T getfirst() {
-		return first;
-	}
-	D getsecond() {
-		return second;
-	}
-private:
-	T first;
-	D second;
-};
-
-template <typename T>
-class Point {
-	T x, y;
-public: 
-	Point(T x, T y) : x(x), y(y) {}
-
-	Point operator+(const Point& other) const { return Point(x + other.x, y + other.y); }
-
-	Point operator-(const Point& other) const { return Point(x - other.x, y - other.y); }
-
-	void print() const { cout << "(" << x << "," << y << ")"; }
-
-	T getX() const { return x; }
-	T getY() const { return y; }
-
-	void setX(T x) { this->x = x; }
-	void setY(T y) { this->y = y; }
-};
-
-template <typename T>
-class Stack {
-	vector<T> data;
-public:
-	void push(const T& value) { data.push_back(value); }
-	void pop() { data.pop_back(); }
-	T top() const { cout << "\n"; return data.back(); }
-	bool empty() const { cout << "\n"; return data.empty(); }
-
-	void print() const { cout << "\n";  copy(data.begin(), data.end(), ostream_iterator<T>(cout, " ")); }
-};
-
-template <typename T>
-class Complex {
-	T real, imag;
-public:
-	Complex(T r = 0, T i = 0) : real(r), imag(i) {}
-
-	Complex operator+(const Complex& other) const {
-		return Complex(real + other.real, imag + other.imag);
-	}
-
-	Complex operator-(const Complex& other) const {
-		return Complex(real - other.real, imag - other.imag);
-	}
-
-	void print() const { cout << real << "+" << imag << "i" << "\n"; }
-};
-
-template <typename T>
-class Queue {
-	list<T> data;
-public:
-	void enqueue(const T& value) { data.push_back(value); }
-	void dequeue() { data.pop_front(); }
-	T front() const { return data.front(); }
-	bool empty() const { return data.empty(); }
-
-	void print() const {
-		for (T i : data) {
-			cout << i;
-		}
-	}
-};
-
-template <typename T>
-class Array {
-private:
-	vector<T> data;
-	int capacity;
-public:
-	void push(const T& value) { data.push_back(value); }
-	void pop() { data.pop_back(); }
-	void print() const { cout << "\n";  copy(data.begin(), data.end(), ostream_iterator<T>(cout, " ")); }
-
-	T& operator[](int index) {
-		if (index < 0 || index >= capacity)
-			throw out_of_range("Index out of bounds");
-		return data[index];
-	}
-
-	int size() const { return capacity; }
-};
-
-template <typename T>
-class DynamicArray {
-private:
-	T* data;
-	int capacity;
-	int count;
-public:
-	DynamicArray() : capacity(10), count(0) {
-		data = new T[capacity];
-	}
-
-	~DynamicArray() {
-		delete[] data;
-	}
-
-	void add(const T& element) {
-		if (count == capacity) {
-			resize();
-		}
-		data[count++] = element;
-	}
-
-	void remove(int index) {
-		if (index < 0 || index >= count)
-			throw out_of_range("Index out of bounds");
-
-		for (int i = index; i < count - 1; ++i) {
-			data[i] = data[i + 1];
-		}
-		count--;
-	}
-
-	void resize() {
-		capacity *= 2;
-		T* newData = new T[capacity];
-		for (int i = 0; i < count; ++i) {
-			newData[i] = data[i];
-		}
-		delete[] data;
-		data = newData;
-	}
-
-	int size() const { return count; }
-	T& operator[](int index) { return data[index]; }
-};
-
-template <typename T>
-class Matrix {
-private:
-	T** data;
-	int rows, cols;
-public:
-	Matrix(int r, int c) : rows(r), cols(c) {
-		data = new T * [rows];
-		for (int i = 0; i < rows; ++i) {
-			data[i] = new T[cols];
-		}
-	}
-
-	~Matrix() {
-		for (int i = 0; i < rows; ++i) {
-			delete[] data[i];
-		}
-		delete[] data;
-	}
-
-	Matrix operator+(const Matrix& other) const {
-		if (rows != other.rows || cols != other.cols)
-			throw invalid_argument("Matrix dimensions must match");
-
-		Matrix result(rows, cols);
-		for (int i = 0; i < rows; ++i) {
-			for (int j = 0; j < cols; ++j) {
-				result.data[i][j] = data[i][j] + other.data[i][j];
-			}
-		}
-		return result;
-	}
-
-	Matrix operator-(const Matrix& other) const {
-		if (rows != other.rows || cols != other.cols)
-			throw invalid_argument("Matrix dimensions must match");
-
-		Matrix result(rows, cols);
-		for (int i = 0; i < rows; ++i) {
-			for (int j = 0; j < cols; ++j) {
-				result.data[i][j] = data[i][j] - other.data[i][j];
-			}
-		}
-		return result;
-	}
-
-	T* operator[](int row) { return data[row]; }
-	int getRows() const { return rows; }
-	int getCols() const { return cols; }
-};
-
-template <typename T>
-class List {
-private:
-	struct Node {
-		T data;
-		Node* next;
-		Node* prev;
-		Node(const T& d) : data(d), next(nullptr), prev(nullptr) {}
-	};
-
-	Node* head;
-	Node* tail;
-	int count;
-public:
-	List() : head(nullptr), tail(nullptr), count(0) {}
-
-	~List() {
-		while (head) {
-			Node* temp = head;
-			head = head->next;
-			delete temp;
-		}
-	}
-
-	void pushFront(const T& data) {
-		Node* newNode = new Node(data);
-		if (!head) {
-			head = tail = newNode;
-		}
-		else {
-			newNode->next = head;
-			head->prev = newNode;
-			head = newNode;
-		}
-		count++;
-	}
-
-	void pushBack(const T& data) {
-		Node* newNode = new Node(data);
-		if (!tail) {
-			head = tail = newNode;
-		}
-		else {
-			newNode->prev = tail;
-			tail->next = newNode;
-			tail = newNode;
-		}
-		count++;
-	}
-
-	void popFront() {
-		if (!head) throw out_of_range("List is empty");
-
-		Node* temp = head;
-		head = head->next;
-		if (head) head->prev = nullptr;
-		else tail = nullptr;
-		delete temp;
-		count--;
-	}
-
-	void popBack() {
-		if (!tail) throw out_of_range("List is empty");
-
-		Node* temp = tail;
-		tail = tail->prev;
-		if (tail) tail->next = nullptr;
-		else head = nullptr;
-		delete temp;
-		count--;
-	}
-
-	int size() const { return count; }
-	bool empty() const { return count == 0; }
-};
-
-template <typename T>
-class Triangle {
-private:
-	Point<T> p1, p2, p3;
-public:
-	Triangle(const Point<T>& a, const Point<T>& b, const Point<T>& c)
-		: p1(a), p2(b), p3(c) {
-	}
-
-	double area() const {
-		T x1 = p1.getX(), y1 = p1.getY();
-		T x2 = p2.getX(), y2 = p2.getY();
-		T x3 = p3.getX(), y3 = p3.getY();
-
-		return abs((x1 * (y2 - y3) + x2 * (y3 - y1) + x3 * (y1 - y2)) / 2.0);
-	}
-};
-
-template <typename T>
-class Graph {
-private:
-	map<T, set<T>> adjList;
-public:
-	void addEdge(const T& src, const T& dest) {
-		adjList[src].insert(dest);
-		adjList[dest].insert(src); //   
-	}
-
-	void removeEdge(const T& src, const T& dest) {
-		adjList[src].erase(dest);
-		adjList[dest].erase(src);
-	}
-
-	bool hasEdge(const T& src, const T& dest) const {
-		auto it = adjList.find(src);
-		if (it != adjList.end()) {
-			return it->second.find(dest) != it->second.end();
-		}
-		return false;
-	}
-};
-
-template <typename T>
-class Cube {
-private:
-	T edgeLength;
-public:
-	Cube(T length) : edgeLength(length) {
-		if (length <= 0) throw invalid_argument("Edge length must be positive");
-	}
-
-	T volume() const {
-		return edgeLength * edgeLength * edgeLength;
-	}
-
-	T surfaceArea() const {
-		return 6 * edgeLength * edgeLength;
-	}
-};
-
-template <typename T>
-class Wrapper {
-private:
-	T value;
-public:
-	Wrapper(const T& val = T()) : value(val) {}
-
-	T get() const { return value; }
-	void set(const T& val) { value = val; }
-
-	operator T() const { return value; }
-	Wrapper& operator=(const T& val) { value = val; return *this; }
+#pragma once
+#include <iostream>
+#include <vector>
+#include <stdexcept> 
+#include <algorithm> 
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <queue>
+#include <limits>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <iterator>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <string_view>
+#include <functional>
+#include "Simd.h"
+#include "Parallel.h"
+#include "Hazard.h"
+#include "Sort.h"
+
+using namespace std;
+
+template <typename T, typename D>
+class Pair {
+public:
+	Pair(T first, D second) : first{ move(first) }, second{ move(second) } {}
+	
+	const T& getfirst() const {
+		return first;
+	}
+	D& getsecond() {
+		return second;
+	}
+	const D& getsecond() const {
+		return second;
+	}
+private:
+	T first;
+	D second;
+};
+
+// Хеш для FlatMap. Для строк прозрачный: искать можно по const char* и string_view без временной string
+template <typename K>
+struct FlatHash {
+	size_t operator()(const K& key) const { return hash<K>()(key); }
+};
+
+template <>
+struct FlatHash<string> {
+	typedef void is_transparent;
+	size_t operator()(string_view key) const { return hash<string_view>()(key); }
+};
+
+// Хеш-таблица с открытой адресацией в духе Swiss table: записи Pair<K, V> лежат подряд в одном
+// массиве, рядом - массив управляющих байтов (старший бит - пусто, иначе 7 бит хеша).
+// Поиск идёт от домашней ячейки линейно, по 16 управляющих байтов за одно SIMD-сравнение.
+// Удаление сдвигает хвост цепочки назад, поэтому "надгробий" нет и цепочки не деградируют.
+// Любая вставка или удаление делает итераторы недействительными
+template <typename K, typename V, typename Hash = FlatHash<K>, typename Eq = equal_to<>>
+class FlatMap {
+public:
+	typedef Pair<K, V> Entry;
+
+private:
+	static const uint8_t emptyByte = 0x80;
+	static const size_t npos = static_cast<size_t>(-1);
+
+	uint8_t* ctrl;
+	Entry* slots;
+	size_t capacity;
+	size_t used;
+	Hash hasher;
+	Eq equal;
+
+	template <typename Q, typename = void>
+	struct Transparent : false_type {};
+
+	template <typename Q>
+	struct Transparent<Q, void_t<typename Q::is_transparent>> : true_type {};
+
+	// Старшие биты выбирают ячейку, младшие 7 идут в управляющий байт
+	template <typename Q>
+	uint64_t hashOf(const Q& key) const {
+		uint64_t h = static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ULL;
+		return h ^ (h >> 32);
+	}
+
+	size_t home(uint64_t h) const { return static_cast<size_t>(h >> 7) & (capacity - 1); }
+
+	void setCtrl(size_t i, uint8_t value) {
+		ctrl[i] = value;
+		// Первые байты продублированы за концом, чтобы группа у края читалась одной загрузкой
+		if (i < simd::groupWidth - 1) ctrl[capacity + i] = value;
+	}
+
+	template <typename Q>
+	size_t findIndex(const Q& key) const {
+		if (used == 0) return npos;
+		return findIndex(key, hashOf(key));
+	}
+
+	template <typename Q>
+	size_t findIndex(const Q& key, uint64_t h) const {
+		if (used == 0) return npos;
+		uint8_t tag = static_cast<uint8_t>(h & 0x7F);
+		size_t mask = capacity - 1;
+		for (size_t pos = home(h);; pos = (pos + simd::groupWidth) & mask) {
+			for (unsigned m = simd::groupMatch(ctrl + pos, tag); m; m &= m - 1) {
+				size_t i = (pos + simd::lowestBit(m)) & mask;
+				if (equal(slots[i].getfirst(), key)) return i;
+			}
+			if (simd::groupHighBits(ctrl + pos)) return npos;
+		}
+	}
+
+	// Первая пустая ячейка от домашней: между домашней и записью пустых не остаётся
+	size_t findEmpty(uint64_t h) const {
+		size_t mask = capacity - 1;
+		for (size_t pos = home(h);; pos = (pos + simd::groupWidth) & mask) {
+			unsigned empty = simd::groupHighBits(ctrl + pos);
+			if (empty) return (pos + simd::lowestBit(empty)) & mask;
+		}
+	}
+
+	void allocate(size_t newCapacity) {
+		capacity = newCapacity;
+		ctrl = static_cast<uint8_t*>(::operator new(capacity + simd::groupWidth - 1));
+		memset(ctrl, emptyByte, capacity + simd::groupWidth - 1);
+		slots = allocator<Entry>().allocate(capacity);
+	}
+
+	void release() {
+		if (!ctrl) return;
+		for (size_t i = 0; i < capacity; ++i) if (!(ctrl[i] & 0x80)) slots[i].~Entry();
+		::operator delete(ctrl);
+		allocator<Entry>().deallocate(slots, capacity);
+		ctrl = nullptr;
+		slots = nullptr;
+		capacity = 0;
+		used = 0;
+	}
+
+	void rehash(size_t newCapacity) {
+		uint8_t* oldCtrl = ctrl;
+		Entry* oldSlots = slots;
+		size_t oldCapacity = capacity;
+		allocate(newCapacity);
+		for (size_t i = 0; i < oldCapacity; ++i) {
+			if (oldCtrl[i] & 0x80) continue;
+			uint64_t h = hashOf(oldSlots[i].getfirst());
+			size_t at = findEmpty(h);
+			::new (static_cast<void*>(slots + at)) Entry(move(oldSlots[i]));
+			setCtrl(at, static_cast<uint8_t>(h & 0x7F));
+			oldSlots[i].~Entry();
+		}
+		if (oldCtrl) {
+			::operator delete(oldCtrl);
+			allocator<Entry>().deallocate(oldSlots, oldCapacity);
+		}
+	}
+
+	// Заполнение не больше 7/8
+	void growFor(size_t needed) {
+		if (needed * 8 <= capacity * 7) return;
+		size_t newCapacity = max<size_t>(capacity, simd::groupWidth);
+		while (needed * 8 > newCapacity * 7) newCapacity *= 2;
+		rehash(newCapacity);
+	}
+
+	void eraseAt(size_t i) {
+		slots[i].~Entry();
+		--used;
+		size_t mask = capacity - 1;
+		size_t hole = i;
+		for (size_t j = (i + 1) & mask; !(ctrl[j] & 0x80); j = (j + 1) & mask) {
+			// Запись из j можно перенести в дыру, если дыра не раньше её домашней ячейки
+			size_t h = home(hashOf(slots[j].getfirst()));
+			if (((j - h) & mask) >= ((j - hole) & mask)) {
+				::new (static_cast<void*>(slots + hole)) Entry(move(slots[j]));
+				slots[j].~Entry();
+				setCtrl(hole, ctrl[j]);
+				hole = j;
+			}
+		}
+		setCtrl(hole, emptyByte);
+	}
+
+	template <bool Const>
+	class Iter {
+		typedef typename conditional<Const, const FlatMap*, FlatMap*>::type Owner;
+		Owner map;
+		size_t index;
+
+		void skipEmpty() {
+			while (index < map->capacity && (map->ctrl[index] & 0x80)) ++index;
+		}
+
+		friend class FlatMap;
+
+	public:
+		typedef forward_iterator_tag iterator_category;
+		typedef Entry value_type;
+		typedef ptrdiff_t difference_type;
+		typedef typename conditional<Const, const Entry*, Entry*>::type pointer;
+		typedef typename conditional<Const, const Entry&, Entry&>::type reference;
+
+		Iter(Owner map, size_t index) : map(map), index(index) { skipEmpty(); }
+		Iter(const Iter<false>& other) : map(other.map), index(other.index) {}
+
+		reference operator*() const { return map->slots[index]; }
+		pointer operator->() const { return &map->slots[index]; }
+		Iter& operator++() { ++index; skipEmpty(); return *this; }
+		Iter operator++(int) { Iter old = *this; ++*this; return old; }
+		bool operator==(const Iter& other) const { return index == other.index; }
+		bool operator!=(const Iter& other) const { return index != other.index; }
+
+		friend class Iter<true>;
+	};
+
+public:
+	typedef Iter<false> iterator;
+	typedef Iter<true> const_iterator;
+
+	FlatMap() : ctrl(nullptr), slots(nullptr), capacity(0), used(0) {}
+
+	explicit FlatMap(size_t expected) : FlatMap() { reserve(expected); }
+
+	FlatMap(const FlatMap& other) : FlatMap() {
+		reserve(other.used);
+		for (const Entry& e : other) emplace(e.getfirst(), e.getsecond());
+	}
+
+	FlatMap(FlatMap&& other) noexcept
+		: ctrl(other.ctrl), slots(other.slots), capacity(other.capacity), used(other.used) {
+		other.ctrl = nullptr;
+		other.slots = nullptr;
+		other.capacity = 0;
+		other.used = 0;
+	}
+
+	FlatMap& operator=(FlatMap other) noexcept {
+		swap(ctrl, other.ctrl);
+		swap(slots, other.slots);
+		swap(capacity, other.capacity);
+		swap(used, other.used);
+		return *this;
+	}
+
+	~FlatMap() { release(); }
+
+	size_t size() const { return used; }
+	bool empty() const { return used == 0; }
+	size_t getCapacity() const { return capacity; }
+
+	void reserve(size_t expected) { growFor(expected); }
+
+	void clear() {
+		if (!ctrl) return;
+		for (size_t i = 0; i < capacity; ++i) if (!(ctrl[i] & 0x80)) slots[i].~Entry();
+		memset(ctrl, emptyByte, capacity + simd::groupWidth - 1);
+		used = 0;
+	}
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, capacity); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, capacity); }
+
+	// Поиск по ключу другого типа - только при прозрачном хеше (FlatHash<string>)
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	iterator find(const Q& key) {
+		size_t i = findIndex(key);
+		return i == npos ? end() : iterator(this, i);
+	}
+
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	const_iterator find(const Q& key) const {
+		size_t i = findIndex(key);
+		return i == npos ? end() : const_iterator(this, i);
+	}
+
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	bool contains(const Q& key) const { return findIndex(key) != npos; }
+
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	size_t count(const Q& key) const { return findIndex(key) != npos ? 1 : 0; }
+
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	V& at(const Q& key) {
+		size_t i = findIndex(key);
+		if (i == npos) throw out_of_range("Key not found");
+		return slots[i].getsecond();
+	}
+
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	const V& at(const Q& key) const {
+		size_t i = findIndex(key);
+		if (i == npos) throw out_of_range("Key not found");
+		return slots[i].getsecond();
+	}
+
+	// Значение строится из args только если ключа ещё нет
+	template <typename... Args>
+	pair<iterator, bool> emplace(const K& key, Args&&... args) {
+		uint64_t h = hashOf(key);
+		size_t i = findIndex(key, h);
+		if (i != npos) return make_pair(iterator(this, i), false);
+		growFor(used + 1);
+		i = findEmpty(h);
+		::new (static_cast<void*>(slots + i)) Entry(key, V(forward<Args>(args)...));
+		setCtrl(i, static_cast<uint8_t>(h & 0x7F));
+		++used;
+		return make_pair(iterator(this, i), true);
+	}
+
+	pair<iterator, bool> insert(const K& key, const V& value) { return emplace(key, value); }
+
+	V& operator[](const K& key) { return emplace(key).first->getsecond(); }
+
+	template <typename Q = K, typename = typename enable_if<is_same<Q, K>::value || Transparent<Hash>::value>::type>
+	bool erase(const Q& key) {
+		size_t i = findIndex(key);
+		if (i == npos) return false;
+		eraseAt(i);
+		return true;
+	}
+};
+
+template <typename T>
+class Point {
+	T x, y;
+public: 
+	Point(T x, T y) : x(x), y(y) {}
+
+	Point operator+(const Point& other) const { return Point(x + other.x, y + other.y); }
+
+	Point operator-(const Point& other) const { return Point(x - other.x, y - other.y); }
+
+	void print() const { cout << "(" << x << "," << y << ")"; }
+
+	T getX() const { return x; }
+	T getY() const { return y; }
+
+	void setX(T x) { this->x = x; }
+	void setY(T y) { this->y = y; }
+};
+
+template <typename T>
+class Stack {
+	vector<T> data;
+public:
+	void push(const T& value) { data.push_back(value); }
+	void push(T&& value) { data.push_back(move(value)); }
+
+	template <typename... Args>
+	T& emplace(Args&&... args) {
+		data.emplace_back(forward<Args>(args)...);
+		return data.back();
+	}
+
+	// Для move-only типов передавайте make_move_iterator
+	template <typename It>
+	void pushRange(It first, It last) { data.insert(data.end(), first, last); }
+
+	void pop() {
+		if (data.empty()) throw out_of_range("Stack is empty");
+		data.pop_back();
+	}
+
+	// Снимает до n элементов с вершины в out (вершина идёт первой), возвращает число снятых
+	template <typename OutIt>
+	size_t popN(OutIt out, size_t n) {
+		size_t taken = min(n, data.size());
+		for (size_t i = 0; i < taken; ++i) {
+			*out++ = move(data.back());
+			data.pop_back();
+		}
+		return taken;
+	}
+
+	T& top() {
+		if (data.empty()) throw out_of_range("Stack is empty");
+		return data.back();
+	}
+
+	const T& top() const {
+		if (data.empty()) throw out_of_range("Stack is empty");
+		return data.back();
+	}
+
+	bool empty() const { return data.empty(); }
+	size_t size() const { return data.size(); }
+
+	void print() const { cout << "\n";  copy(data.begin(), data.end(), ostream_iterator<T>(cout, " ")); }
+};
+
+// Lock-free стек Трайбера для нескольких потоков. Снятые узлы удаляются
+// только когда ни один поток не держит на них указатель опасности
+template <typename T>
+class LockFreeStack {
+private:
+	struct Node {
+		T data;
+		Node* next;
+		Node* retiredNext;
+		template <typename... Args>
+		Node(Args&&... args) : data(forward<Args>(args)...), next(nullptr), retiredNext(nullptr) {}
+	};
+
+	atomic<Node*> head;
+	atomic<Node*> retired;
+	atomic<int> retiredCount;
+
+	void linkChain(Node* first, Node* last) {
+		last->next = head.load(memory_order_relaxed);
+		while (!head.compare_exchange_weak(last->next, first, memory_order_release, memory_order_relaxed)) {}
+	}
+
+	void retire(Node* node) {
+		node->retiredNext = retired.load(memory_order_relaxed);
+		while (!retired.compare_exchange_weak(node->retiredNext, node)) {}
+		retiredCount.fetch_add(1, memory_order_relaxed);
+	}
+
+	// Забирает весь список отложенных узлов, удаляет свободные, остальные возвращает
+	void reclaim() {
+		Node* node = retired.exchange(nullptr);
+		while (node) {
+			Node* next = node->retiredNext;
+			retiredCount.fetch_sub(1, memory_order_relaxed);
+			if (isHazardous(node)) retire(node);
+			else delete node;
+			node = next;
+		}
+	}
+
+	// Снимает вершину; узел остаётся за вызывающим, пока тот не передаст его в dispose
+	Node* detachTop() {
+		atomic<void*>& hazard = hazardPointerForThisThread();
+		Node* node = head.load();
+		do {
+			// Узел публикуется как опасный и перепроверяется: между чтением и публикацией его могли удалить
+			Node* seen;
+			do {
+				seen = node;
+				hazard.store(node);
+				node = head.load();
+			} while (node != seen);
+		} while (node && !head.compare_exchange_strong(node, node->next));
+		hazard.store(nullptr);
+		return node;
+	}
+
+	void dispose(Node* node) {
+		if (isHazardous(node)) retire(node);
+		else delete node;
+		if (retiredCount.load(memory_order_relaxed) > maxHazardThreads) reclaim();
+	}
+
+public:
+	LockFreeStack() : head(nullptr), retired(nullptr), retiredCount(0) {}
+
+	LockFreeStack(const LockFreeStack&) = delete;
+	LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+	// Разрушать можно только когда другие потоки со стеком уже не работают
+	~LockFreeStack() {
+		for (Node* n = head.load(); n;) {
+			Node* next = n->next;
+			delete n;
+			n = next;
+		}
+		for (Node* n = retired.load(); n;) {
+			Node* next = n->retiredNext;
+			delete n;
+			n = next;
+		}
+	}
+
+	void push(const T& value) { emplace(value); }
+	void push(T&& value) { emplace(move(value)); }
+
+	template <typename... Args>
+	void emplace(Args&&... args) {
+		Node* node = new Node(forward<Args>(args)...);
+		linkChain(node, node);
+	}
+
+	// Цепочка собирается локально и публикуется одним CAS
+	template <typename It>
+	void pushRange(It first, It last) {
+		if (first == last) return;
+		Node* top = new Node(*first);
+		Node* bottom = top;
+		for (++first; first != last; ++first) {
+			Node* node = new Node(*first);
+			node->next = top;
+			top = node;
+		}
+		linkChain(top, bottom);
+	}
+
+	bool tryPop(T& out) {
+		Node* node = detachTop();
+		if (!node) return false;
+		out = move(node->data);
+		dispose(node);
+		return true;
+	}
+
+	// Значения переносятся из узлов прямо в out, так что T не обязан иметь конструктор по умолчанию
+	template <typename OutIt>
+	size_t popN(OutIt out, size_t n) {
+		size_t taken = 0;
+		Node* node;
+		while (taken < n && (node = detachTop())) {
+			*out++ = move(node->data);
+			dispose(node);
+			taken++;
+		}
+		return taken;
+	}
+
+	// Снимок: при параллельной работе может устареть сразу после возврата
+	bool empty() const { return head.load() == nullptr; }
+};
+
+template <typename T>
+class Complex {
+	T real, imag;
+public:
+	Complex(T r = 0, T i = 0) : real(r), imag(i) {}
+
+	Complex operator+(const Complex& other) const {
+		return Complex(real + other.real, imag + other.imag);
+	}
+
+	Complex operator-(const Complex& other) const {
+		return Complex(real - other.real, imag - other.imag);
+	}
+
+	Complex operator*(const Complex& other) const {
+		return Complex(real * other.real - imag * other.imag, real * other.imag + imag * other.real);
+	}
+
+	Complex operator/(const Complex& other) const {
+		T norm = other.real * other.real + other.imag * other.imag;
+		if (norm == T(0)) throw runtime_error("Division by zero");
+		return Complex((real * other.real + imag * other.imag) / norm, (imag * other.real - real * other.imag) / norm);
+	}
+
+	Complex& operator+=(const Complex& other) { return *this = *this + other; }
+	Complex& operator-=(const Complex& other) { return *this = *this - other; }
+	Complex& operator*=(const Complex& other) { return *this = *this * other; }
+	Complex& operator/=(const Complex& other) { return *this = *this / other; }
+
+	bool operator==(const Complex& other) const { return real == other.real && imag == other.imag; }
+	bool operator!=(const Complex& other) const { return !(*this == other); }
+
+	Complex conjugate() const { return Complex(real, -imag); }
+
+	// hypot не переполняется на больших частях, в отличие от sqrt(re*re + im*im)
+	double magnitude() const { return hypot(static_cast<double>(real), static_cast<double>(imag)); }
+
+	T getReal() const { return real; }
+	T getImag() const { return imag; }
+
+	void print() const { cout << real << "+" << imag << "i" << "\n"; }
+};
+
+// Массив комплексных чисел в раздельном виде: действительные и мнимые части лежат
+// в двух непрерывных массивах, поэтому поэлементные операции идут SIMD-ядрами
+template <typename T>
+class ComplexArray {
+	vector<T> re, im;
+
+	void checkSize(const ComplexArray& other) const {
+		if (other.size() != size()) throw invalid_argument("Array sizes must match");
+	}
+
+public:
+	ComplexArray() {}
+	explicit ComplexArray(size_t n) : re(n), im(n) {}
+	ComplexArray(vector<T> real, vector<T> imag) : re(move(real)), im(move(imag)) {
+		if (re.size() != im.size()) throw invalid_argument("Array sizes must match");
+	}
+	ComplexArray(const vector<Complex<T>>& values) : re(values.size()), im(values.size()) {
+		for (size_t i = 0; i < values.size(); ++i) {
+			re[i] = values[i].getReal();
+			im[i] = values[i].getImag();
+		}
+	}
+
+	size_t size() const { return re.size(); }
+	bool empty() const { return re.empty(); }
+
+	void resize(size_t n) {
+		re.resize(n);
+		im.resize(n);
+	}
+
+	Complex<T> get(size_t i) const {
+		if (i >= size()) throw out_of_range("Index out of range");
+		return Complex<T>(re[i], im[i]);
+	}
+
+	void set(size_t i, const Complex<T>& value) {
+		if (i >= size()) throw out_of_range("Index out of range");
+		re[i] = value.getReal();
+		im[i] = value.getImag();
+	}
+
+	T* realData() { return re.data(); }
+	T* imagData() { return im.data(); }
+	const T* realData() const { return re.data(); }
+	const T* imagData() const { return im.data(); }
+
+	vector<Complex<T>> toVector() const {
+		vector<Complex<T>> result;
+		result.reserve(size());
+		for (size_t i = 0; i < size(); ++i) result.emplace_back(re[i], im[i]);
+		return result;
+	}
+
+	ComplexArray& operator+=(const ComplexArray& other) {
+		checkSize(other);
+		simd::add(re.data(), other.re.data(), re.data(), size());
+		simd::add(im.data(), other.im.data(), im.data(), size());
+		return *this;
+	}
+
+	ComplexArray& operator-=(const ComplexArray& other) {
+		checkSize(other);
+		simd::sub(re.data(), other.re.data(), re.data(), size());
+		simd::sub(im.data(), other.im.data(), im.data(), size());
+		return *this;
+	}
+
+	ComplexArray& operator*=(const ComplexArray& other) {
+		checkSize(other);
+		simd::complexMul(re.data(), im.data(), other.re.data(), other.im.data(), re.data(), im.data(), size());
+		return *this;
+	}
+
+	// Нули в делителе не проверяются: для float/double дают inf и NaN, как при обычном делении
+	ComplexArray& operator/=(const ComplexArray& other) {
+		checkSize(other);
+		simd::complexDiv(re.data(), im.data(), other.re.data(), other.im.data(), re.data(), im.data(), size());
+		return *this;
+	}
+
+	ComplexArray& operator*=(T factor) {
+		simd::scale(re.data(), factor, re.data(), size());
+		simd::scale(im.data(), factor, im.data(), size());
+		return *this;
+	}
+
+	ComplexArray operator+(const ComplexArray& other) const { ComplexArray result(*this); return result += other; }
+	ComplexArray operator-(const ComplexArray& other) const { ComplexArray result(*this); return result -= other; }
+	ComplexArray operator*(const ComplexArray& other) const { ComplexArray result(*this); return result *= other; }
+	ComplexArray operator/(const ComplexArray& other) const { ComplexArray result(*this); return result /= other; }
+
+	void conjugate() { simd::scale(im.data(), T(-1), im.data(), size()); }
+
+	vector<T> magnitude() const {
+		vector<T> result(size());
+		simd::complexAbs(re.data(), im.data(), result.data(), size());
+		return result;
+	}
+};
+
+template <typename T>
+class Queue {
+	list<T> data;
+public:
+	void enqueue(const T& value) { data.push_back(value); }
+	void dequeue() { data.pop_front(); }
+	T front() const { return data.front(); }
+	bool empty() const { return data.empty(); }
+
+	void print() const {
+		for (T i : data) {
+			cout << i;
+		}
+	}
+};
+
+// Ограниченная lock-free очередь для нескольких производителей и потребителей
+// (кольцевой буфер с номером поколения в каждой ячейке, схема Вьюкова).
+// Ёмкость округляется вверх до степени двойки. Каждая ячейка занимает свою строку кеша:
+// производитель и потребитель на соседних ячейках не делят строку, ценой памяти
+// (для мелких T - 64 байта на элемент)
+template <typename T>
+class RingQueue {
+private:
+	static const size_t cacheLine = 64;
+
+	struct alignas(cacheLine) Cell {
+		atomic<size_t> sequence;
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		T* value() { return reinterpret_cast<T*>(storage); }
+	};
+
+	unique_ptr<Cell[]> cells;
+	size_t mask;
+	alignas(cacheLine) atomic<size_t> tail;
+	alignas(cacheLine) atomic<size_t> head;
+
+	static size_t roundUpPow2(size_t n) {
+		size_t p = 2;
+		while (p < n) p <<= 1;
+		return p;
+	}
+
+	template <typename U>
+	bool push(U&& value) {
+		size_t pos = tail.load(memory_order_relaxed);
+		for (;;) {
+			Cell& cell = cells[pos & mask];
+			size_t seq = cell.sequence.load(memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+					::new (static_cast<void*>(cell.storage)) T(forward<U>(value));
+					cell.sequence.store(pos + 1, memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = tail.load(memory_order_relaxed);
+			}
+		}
+	}
+
+	template <typename F>
+	bool pop(F&& consume) {
+		size_t pos = head.load(memory_order_relaxed);
+		for (;;) {
+			Cell& cell = cells[pos & mask];
+			size_t seq = cell.sequence.load(memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0) {
+				if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+					T* value = cell.value();
+					consume(move(*value));
+					value->~T();
+					cell.sequence.store(pos + mask + 1, memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = head.load(memory_order_relaxed);
+			}
+		}
+	}
+
+public:
+	explicit RingQueue(size_t capacity = 1024) : cells(new Cell[roundUpPow2(capacity)]), mask(roundUpPow2(capacity) - 1), tail(0), head(0) {
+		for (size_t i = 0; i <= mask; ++i) {
+			cells[i].sequence.store(i, memory_order_relaxed);
+		}
+	}
+
+	RingQueue(const RingQueue&) = delete;
+	RingQueue& operator=(const RingQueue&) = delete;
+
+	~RingQueue() {
+		while (pop([](T&&) {})) {}
+	}
+
+	bool tryEnqueue(const T& value) { return push(value); }
+	bool tryEnqueue(T&& value) { return push(move(value)); }
+
+	bool tryDequeue(T& out) {
+		return pop([&](T&& value) { out = move(value); });
+	}
+
+	// Блокирующие варианты: ждут места или элемента, уступая процессор
+	void enqueue(const T& value) {
+		while (!push(value)) this_thread::yield();
+	}
+
+	void enqueue(T&& value) {
+		while (!push(move(value))) this_thread::yield();
+	}
+
+	void dequeue() {
+		while (!pop([](T&&) {})) this_thread::yield();
+	}
+
+	void dequeue(T& out) {
+		while (!tryDequeue(out)) this_thread::yield();
+	}
+
+	// Пакетные варианты: возвращают, сколько элементов удалось передать
+	template <typename It>
+	size_t tryEnqueueBulk(It first, It last) {
+		size_t done = 0;
+		for (; first != last && push(*first); ++first) done++;
+		return done;
+	}
+
+	template <typename OutIt>
+	size_t tryDequeueBulk(OutIt out, size_t maxCount) {
+		size_t done = 0;
+		while (done < maxCount && pop([&](T&& value) { *out++ = move(value); })) done++;
+		return done;
+	}
+
+	// Копия головного элемента. Надёжна, только пока другие потоки не извлекают
+	T front() const {
+		size_t pos = head.load(memory_order_acquire);
+		Cell& cell = cells[pos & mask];
+		if (cell.sequence.load(memory_order_acquire) != pos + 1)
+			throw out_of_range("Queue is empty");
+		return *cell.value();
+	}
+
+	// Снимок: при параллельной работе может устареть сразу после возврата
+	bool empty() const {
+		size_t pos = head.load(memory_order_acquire);
+		return cells[pos & mask].sequence.load(memory_order_acquire) != pos + 1;
+	}
+
+	size_t capacity() const { return mask + 1; }
+
+	// Печатает готовые элементы от головы и останавливается на ячейке, которую производитель
+	// ещё не заполнил. Как и front(), надёжна, только пока другие потоки не извлекают
+	void print() const {
+		for (size_t pos = head.load(memory_order_acquire);; ++pos) {
+			Cell& cell = cells[pos & mask];
+			if (cell.sequence.load(memory_order_acquire) != pos + 1) break;
+			cout << *cell.value();
+		}
+	}
+};
+
+// Проверка индекса в Array::operator[]: по умолчанию включена в отладочной сборке и
+// выключена при NDEBUG, ARRAY_CHECKED=0/1 задаёт режим явно. at() проверяет всегда
+#ifndef ARRAY_CHECKED
+#ifdef NDEBUG
+#define ARRAY_CHECKED 0
+#else
+#define ARRAY_CHECKED 1
+#endif
+#endif
+
+const size_t dynamicExtent = static_cast<size_t>(-1);
+
+// Массив фиксированной длины N: элементы хранятся прямо в объекте, без кучи.
+// Построение, доступ, sum/min/max и sort - constexpr, поэтому таблицы можно считать
+// при компиляции. Выход за границы в константном выражении - ошибка компиляции
+template <typename T, size_t N = dynamicExtent>
+class Array {
+	T items[N > 0 ? N : 1];
+
+	static constexpr void checkIndex(size_t index) {
+		if (index >= N) throw out_of_range("Index out of bounds");
+	}
+
+	// Куча над [0, n): ни рекурсии, ни дополнительной памяти - подходит для constexpr
+	constexpr void siftDown(size_t root, size_t n) {
+		while (2 * root + 1 < n) {
+			size_t child = 2 * root + 1;
+			if (child + 1 < n && items[child] < items[child + 1]) ++child;
+			if (!(items[root] < items[child])) return;
+			swapItems(root, child);
+			root = child;
+		}
+	}
+
+	constexpr void swapItems(size_t a, size_t b) {
+		T tmp = items[a];
+		items[a] = items[b];
+		items[b] = tmp;
+	}
+
+public:
+	constexpr Array() : items{} {}
+
+	// Недостающие до N элементы инициализируются значением по умолчанию
+	template <typename... Args, typename = enable_if_t<(sizeof...(Args) > 0 && sizeof...(Args) <= N)>>
+	constexpr Array(const Args&... values) : items{ static_cast<T>(values)... } {}
+
+	// Таблица из функции индекса: Array<int, 10>::generate([](size_t i) { return int(i * i); })
+	template <typename F>
+	static constexpr Array generate(F f) {
+		Array result;
+		for (size_t i = 0; i < N; ++i) result.items[i] = f(i);
+		return result;
+	}
+
+	static constexpr size_t size() { return N; }
+	static constexpr bool empty() { return N == 0; }
+
+	constexpr T& operator[](size_t index) {
+		if (ARRAY_CHECKED) checkIndex(index);
+		return items[index];
+	}
+
+	constexpr const T& operator[](size_t index) const {
+		if (ARRAY_CHECKED) checkIndex(index);
+		return items[index];
+	}
+
+	constexpr T& at(size_t index) {
+		checkIndex(index);
+		return items[index];
+	}
+
+	constexpr const T& at(size_t index) const {
+		checkIndex(index);
+		return items[index];
+	}
+
+	constexpr T* data() { return items; }
+	constexpr const T* data() const { return items; }
+	constexpr T* begin() { return items; }
+	constexpr T* end() { return items + N; }
+	constexpr const T* begin() const { return items; }
+	constexpr const T* end() const { return items + N; }
+
+	constexpr void fill(const T& value) {
+		for (size_t i = 0; i < N; ++i) items[i] = value;
+	}
+
+	constexpr T sum() const {
+		T total{};
+		for (size_t i = 0; i < N; ++i) total += items[i];
+		return total;
+	}
+
+	constexpr const T& min() const {
+		static_assert(N > 0, "min() of an empty Array");
+		size_t best = 0;
+		for (size_t i = 1; i < N; ++i) if (items[i] < items[best]) best = i;
+		return items[best];
+	}
+
+	constexpr const T& max() const {
+		static_assert(N > 0, "max() of an empty Array");
+		size_t best = 0;
+		for (size_t i = 1; i < N; ++i) if (items[best] < items[i]) best = i;
+		return items[best];
+	}
+
+	// N или индекс первого совпадения
+	constexpr size_t find(const T& value) const {
+		for (size_t i = 0; i < N; ++i) if (items[i] == value) return i;
+		return N;
+	}
+
+	constexpr bool contains(const T& value) const { return find(value) != N; }
+
+	// Короткие массивы - вставками, длинные - пирамидальной сортировкой (std::sort не constexpr до C++20)
+	constexpr void sort() {
+		if (N <= 16) {
+			for (size_t i = 1; i < N; ++i) {
+				T value = items[i];
+				size_t j = i;
+				for (; j > 0 && value < items[j - 1]; --j) items[j] = items[j - 1];
+				items[j] = value;
+			}
+			return;
+		}
+		for (size_t i = N / 2; i-- > 0;) siftDown(i, N);
+		for (size_t end = N - 1; end > 0; --end) {
+			swapItems(0, end);
+			siftDown(0, end);
+		}
+	}
+
+	constexpr Array sorted() const {
+		Array result = *this;
+		result.sort();
+		return result;
+	}
+
+	constexpr bool operator==(const Array& other) const {
+		for (size_t i = 0; i < N; ++i) if (!(items[i] == other.items[i])) return false;
+		return true;
+	}
+
+	constexpr bool operator!=(const Array& other) const { return !(*this == other); }
+
+	void print() const { cout << "\n";  copy(begin(), end(), ostream_iterator<T>(cout, " ")); }
+};
+
+// Длина не задана: прежний растущий массив на vector
+template <typename T>
+class Array<T, dynamicExtent> {
+private:
+	vector<T> data;
+public:
+	void push(const T& value) { data.push_back(value); }
+	void pop() { data.pop_back(); }
+	void print() const { cout << "\n";  copy(data.begin(), data.end(), ostream_iterator<T>(cout, " ")); }
+
+	T& operator[](int index) {
+		if (index < 0 || index >= size())
+			throw out_of_range("Index out of bounds");
+		return data[index];
+	}
+
+	int size() const { return static_cast<int>(data.size()); }
+};
+
+// Первые InlineCapacity элементов живут прямо в объекте, дальше - в куче.
+// Память под элементы не инициализируется заранее: объекты создаются placement-new
+template <typename T, int InlineCapacity = 0>
+class DynamicArray {
+private:
+	static const int defaultCapacity = 10;
+	static const bool relocatable = is_trivially_copyable<T>::value;
+
+	T* data;
+	int capacity;
+	int count;
+	double growth;
+	alignas(T) unsigned char inlineBuf[InlineCapacity > 0 ? InlineCapacity * sizeof(T) : 1];
+
+	T* inlineData() { return reinterpret_cast<T*>(inlineBuf); }
+	bool isInline() const { return data == reinterpret_cast<const T*>(inlineBuf); }
+
+	static T* allocateRaw(int n) { return static_cast<T*>(::operator new(static_cast<size_t>(n) * sizeof(T))); }
+
+	void freeRaw(T* p) {
+		if (p && p != inlineData()) ::operator delete(p);
+	}
+
+	// Перенос n элементов из src в неинициализированный dst; src после этого пуст
+	static void relocate(T* src, int n, T* dst) {
+		if (n <= 0) return;
+		if constexpr (relocatable) {
+			memcpy(static_cast<void*>(dst), static_cast<const void*>(src), static_cast<size_t>(n) * sizeof(T));
+		}
+		else {
+			uninitialized_move(src, src + n, dst);
+			destroy_n(src, n);
+		}
+	}
+
+	int grownCapacity(int needed) const {
+		int next = capacity > 0 ? static_cast<int>(capacity * growth) : defaultCapacity;
+		if (next <= capacity) next = capacity + 1;
+		return max(next, needed);
+	}
+
+	void reallocate(int newCapacity) {
+		T* newData = InlineCapacity > 0 && newCapacity <= InlineCapacity ? inlineData() : allocateRaw(newCapacity);
+		if (newData == data) return;
+		relocate(data, count, newData);
+		freeRaw(data);
+		data = newData;
+		capacity = max(newCapacity, InlineCapacity);
+	}
+
+	void initEmpty() {
+		data = InlineCapacity > 0 ? inlineData() : nullptr;
+		capacity = InlineCapacity;
+		count = 0;
+	}
+
+	void takeFrom(DynamicArray& other) {
+		growth = other.growth;
+		if (other.isInline()) {
+			initEmpty();
+			relocate(other.data, other.count, data);
+			count = other.count;
+			other.count = 0;
+		}
+		else {
+			data = other.data;
+			capacity = other.capacity;
+			count = other.count;
+			other.initEmpty();
+		}
+	}
+
+	template <typename... Args>
+	T& emplaceGrow(Args&&... args) {
+		// Новый элемент строится до переноса старых: аргумент может ссылаться внутрь массива
+		int newCapacity = grownCapacity(count + 1);
+		T* newData = allocateRaw(newCapacity);
+		try {
+			::new (static_cast<void*>(newData + count)) T(forward<Args>(args)...);
+		}
+		catch (...) {
+			::operator delete(newData);
+			throw;
+		}
+		relocate(data, count, newData);
+		freeRaw(data);
+		data = newData;
+		capacity = newCapacity;
+		return data[count++];
+	}
+
+public:
+	explicit DynamicArray(double growthFactor = 2.0) : growth(growthFactor) {
+		if (growthFactor <= 1.0) throw invalid_argument("Growth factor must be greater than 1");
+		initEmpty();
+	}
+
+	DynamicArray(const DynamicArray& other) : growth(other.growth) {
+		initEmpty();
+		reserve(other.count);
+		uninitialized_copy(other.data, other.data + other.count, data);
+		count = other.count;
+	}
+
+	DynamicArray(DynamicArray&& other) noexcept {
+		takeFrom(other);
+	}
+
+	DynamicArray& operator=(const DynamicArray& other) {
+		if (this == &other) return *this;
+		DynamicArray copyOf(other);
+		clear();
+		freeRaw(data);
+		takeFrom(copyOf);
+		return *this;
+	}
+
+	DynamicArray& operator=(DynamicArray&& other) noexcept {
+		if (this == &other) return *this;
+		clear();
+		freeRaw(data);
+		takeFrom(other);
+		return *this;
+	}
+
+	~DynamicArray() {
+		clear();
+		freeRaw(data);
+	}
+
+	void add(const T& element) { emplace(element); }
+	void add(T&& element) { emplace(move(element)); }
+
+	template <typename... Args>
+	T& emplace(Args&&... args) {
+		if (count == capacity) return emplaceGrow(forward<Args>(args)...);
+		::new (static_cast<void*>(data + count)) T(forward<Args>(args)...);
+		return data[count++];
+	}
+
+	void remove(int index) {
+		if (index < 0 || index >= count)
+			throw out_of_range("Index out of bounds");
+		erase(index, index + 1);
+	}
+
+	// Удаление [first, last) одним сдвигом хвоста
+	void erase(int first, int last) {
+		if (first < 0 || last > count || first > last)
+			throw out_of_range("Index out of bounds");
+		int removed = last - first;
+		if (removed == 0) return;
+
+		if constexpr (relocatable) {
+			memmove(static_cast<void*>(data + first), static_cast<const void*>(data + last),
+				static_cast<size_t>(count - last) * sizeof(T));
+		}
+		else {
+			move(data + last, data + count, data + first);
+			destroy(data + count - removed, data + count);
+		}
+		count -= removed;
+	}
+
+	// Вставка [from, to) перед позицией index; хвост сдвигается один раз
+	template <typename It>
+	void insert(int index, It from, It to) {
+		if (index < 0 || index > count)
+			throw out_of_range("Index out of bounds");
+		int added = static_cast<int>(distance(from, to));
+		if (added <= 0) return;
+		int tail = count - index;
+
+		if (count + added > capacity) {
+			int newCapacity = grownCapacity(count + added);
+			T* newData = allocateRaw(newCapacity);
+			try {
+				uninitialized_copy(from, to, newData + index);
+			}
+			catch (...) {
+				::operator delete(newData);
+				throw;
+			}
+			relocate(data + index, tail, newData + index + added);
+			relocate(data, index, newData);
+			freeRaw(data);
+			data = newData;
+			capacity = newCapacity;
+		}
+		else if constexpr (relocatable) {
+			memmove(static_cast<void*>(data + index + added), static_cast<const void*>(data + index),
+				static_cast<size_t>(tail) * sizeof(T));
+			uninitialized_copy(from, to, data + index);
+		}
+		else {
+			// Часть хвоста уезжает в неинициализированную память, остальное сдвигается присваиванием
+			int moved = min(tail, added);
+			uninitialized_move(data + count - moved, data + count, data + count + added - moved);
+			move_backward(data + index, data + count - moved, data + count);
+			It it = from;
+			int i = index;
+			for (; i < index + added && i < count; ++i, ++it) data[i] = *it;
+			uninitialized_copy(it, to, data + i);
+		}
+		count += added;
+	}
+
+	void resize() { reallocate(grownCapacity(count + 1)); }
+
+	void reserve(int newCapacity) {
+		if (newCapacity > capacity) reallocate(newCapacity);
+	}
+
+	void shrinkToFit() {
+		if (isInline() || count == capacity) return;
+		if (count == 0 && InlineCapacity == 0) {
+			freeRaw(data);
+			initEmpty();
+			return;
+		}
+		reallocate(count);
+	}
+
+	void clear() {
+		destroy_n(data, count);
+		count = 0;
+	}
+
+	void setGrowthFactor(double factor) {
+		if (factor <= 1.0) throw invalid_argument("Growth factor must be greater than 1");
+		growth = factor;
+	}
+
+	int size() const { return count; }
+	int getCapacity() const { return capacity; }
+	T& operator[](int index) { return data[index]; }
+	const T& operator[](int index) const { return data[index]; }
+	T* begin() { return data; }
+	T* end() { return data + count; }
+	const T* begin() const { return data; }
+	const T* end() const { return data + count; }
+};
+
+template <typename T>
+class Matrix;
+
+// Базовый класс выражений над матрицами (CRTP). Узлы выражений ленивые:
+// a + b - c ничего не вычисляет, пока результат не присвоен в Matrix
+template <typename E>
+class MatrixExpr {
+public:
+	const E& self() const { return static_cast<const E&>(*this); }
+};
+
+// Матрицы-листья хранятся в узлах по ссылке, вложенные узлы - по значению.
+// Поэтому выражение нужно присваивать сразу, а не держать в auto дольше операндов
+template <typename E>
+struct MatrixExprRef { typedef E type; };
+
+template <typename T>
+struct MatrixExprRef<Matrix<T>> { typedef const Matrix<T>& type; };
+
+template <typename L, typename R>
+class MatrixSum : public MatrixExpr<MatrixSum<L, R>> {
+	typename MatrixExprRef<L>::type lhs;
+	typename MatrixExprRef<R>::type rhs;
+public:
+	typedef typename L::value_type value_type;
+	static const bool hasTranspose = L::hasTranspose || R::hasTranspose;
+
+	MatrixSum(const L& l, const R& r) : lhs(l), rhs(r) {
+		if (l.getRows() != r.getRows() || l.getCols() != r.getCols())
+			throw invalid_argument("Matrix dimensions must match");
+	}
+
+	value_type operator()(int i, int j) const { return lhs(i, j) + rhs(i, j); }
+	int getRows() const { return lhs.getRows(); }
+	int getCols() const { return lhs.getCols(); }
+	bool aliases(const void* p) const { return lhs.aliases(p) || rhs.aliases(p); }
+	const L& left() const { return lhs; }
+	const R& right() const { return rhs; }
+};
+
+template <typename L, typename R>
+class MatrixDiff : public MatrixExpr<MatrixDiff<L, R>> {
+	typename MatrixExprRef<L>::type lhs;
+	typename MatrixExprRef<R>::type rhs;
+public:
+	typedef typename L::value_type value_type;
+	static const bool hasTranspose = L::hasTranspose || R::hasTranspose;
+
+	MatrixDiff(const L& l, const R& r) : lhs(l), rhs(r) {
+		if (l.getRows() != r.getRows() || l.getCols() != r.getCols())
+			throw invalid_argument("Matrix dimensions must match");
+	}
+
+	value_type operator()(int i, int j) const { return lhs(i, j) - rhs(i, j); }
+	int getRows() const { return lhs.getRows(); }
+	int getCols() const { return lhs.getCols(); }
+	bool aliases(const void* p) const { return lhs.aliases(p) || rhs.aliases(p); }
+	const L& left() const { return lhs; }
+	const R& right() const { return rhs; }
+};
+
+template <typename E>
+class MatrixScaled : public MatrixExpr<MatrixScaled<E>> {
+public:
+	typedef typename E::value_type value_type;
+	static const bool hasTranspose = E::hasTranspose;
+private:
+	typename MatrixExprRef<E>::type expr;
+	value_type factor;
+public:
+	MatrixScaled(const E& e, const value_type& s) : expr(e), factor(s) {}
+
+	value_type operator()(int i, int j) const { return expr(i, j) * factor; }
+	int getRows() const { return expr.getRows(); }
+	int getCols() const { return expr.getCols(); }
+	bool aliases(const void* p) const { return expr.aliases(p); }
+	const E& operand() const { return expr; }
+	value_type scalar() const { return factor; }
+};
+
+template <typename E>
+class MatrixTransposed : public MatrixExpr<MatrixTransposed<E>> {
+	typename MatrixExprRef<E>::type expr;
+public:
+	typedef typename E::value_type value_type;
+	static const bool hasTranspose = true;
+
+	MatrixTransposed(const E& e) : expr(e) {}
+
+	value_type operator()(int i, int j) const { return expr(j, i); }
+	int getRows() const { return expr.getCols(); }
+	int getCols() const { return expr.getRows(); }
+	bool aliases(const void* p) const { return expr.aliases(p); }
+};
+
+template <typename T>
+class Matrix : public MatrixExpr<Matrix<T>> {
+private:
+	T* data;
+	int rows, cols;
+	int stride;
+
+	void allocate() {
+		stride = static_cast<int>(simd::paddedCount<T>(cols));
+		size_t total = static_cast<size_t>(rows) * stride;
+		data = static_cast<T*>(simd::alignedAlloc(max<size_t>(total, 1) * sizeof(T)));
+		uninitialized_fill_n(data, total, T());
+	}
+
+	void release() {
+		if (!data) return;
+		destroy_n(data, static_cast<size_t>(rows) * stride);
+		simd::alignedFree(data);
+		data = nullptr;
+	}
+
+	size_t storageSize() const { return static_cast<size_t>(rows) * stride; }
+
+	void reshape(int r, int c) {
+		if (rows == r && cols == c && data) return;
+		release();
+		rows = r;
+		cols = c;
+		allocate();
+	}
+
+	// Один проход по результату. Простые a + b, a - b и a * s уходят в SIMD-ядра,
+	// остальные цепочки считаются поэлементно без промежуточных матриц
+	template <typename E>
+	void evaluate(const E& e) {
+		if constexpr (is_same<E, MatrixSum<Matrix, Matrix>>::value) {
+			simd::add(e.left().data, e.right().data, data, storageSize());
+		}
+		else if constexpr (is_same<E, MatrixDiff<Matrix, Matrix>>::value) {
+			simd::sub(e.left().data, e.right().data, data, storageSize());
+		}
+		else if constexpr (is_same<E, MatrixScaled<Matrix>>::value) {
+			simd::scale(e.operand().data, e.scalar(), data, storageSize());
+		}
+		else {
+			for (int i = 0; i < rows; ++i) {
+				T* row = data + static_cast<size_t>(i) * stride;
+				for (int j = 0; j < cols; ++j) {
+					row[j] = e(i, j);
+				}
+			}
+		}
+	}
+
+public:
+	typedef T value_type;
+	static const bool hasTranspose = false;
+
+	Matrix(int r, int c) : data(nullptr), rows(r), cols(c), stride(0) {
+		if (r < 0 || c < 0) throw invalid_argument("Matrix dimensions must be non-negative");
+		allocate();
+	}
+
+	Matrix(const Matrix& other) : data(nullptr), rows(other.rows), cols(other.cols), stride(0) {
+		allocate();
+		copy(other.data, other.data + storageSize(), data);
+	}
+
+	Matrix(Matrix&& other) noexcept : data(other.data), rows(other.rows), cols(other.cols), stride(other.stride) {
+		other.data = nullptr;
+		other.rows = other.cols = other.stride = 0;
+	}
+
+	template <typename E>
+	Matrix(const MatrixExpr<E>& expr) : data(nullptr), rows(expr.self().getRows()), cols(expr.self().getCols()), stride(0) {
+		allocate();
+		evaluate(expr.self());
+	}
+
+	Matrix& operator=(const Matrix& other) {
+		if (this == &other) return *this;
+		reshape(other.rows, other.cols);
+		copy(other.data, other.data + storageSize(), data);
+		return *this;
+	}
+
+	Matrix& operator=(Matrix&& other) noexcept {
+		if (this == &other) return *this;
+		release();
+		data = other.data;
+		rows = other.rows;
+		cols = other.cols;
+		stride = other.stride;
+		other.data = nullptr;
+		other.rows = other.cols = other.stride = 0;
+		return *this;
+	}
+
+	// Поэлементные выражения можно писать прямо в себя (a = a + b),
+	// а транспонирование с участием самой матрицы сначала считается во временную
+	template <typename E>
+	Matrix& operator=(const MatrixExpr<E>& expr) {
+		const E& e = expr.self();
+		if (E::hasTranspose && e.aliases(this)) {
+			*this = Matrix(e);
+			return *this;
+		}
+		reshape(e.getRows(), e.getCols());
+		evaluate(e);
+		return *this;
+	}
+
+	~Matrix() {
+		release();
+	}
+
+	// Блочное умножение: строки результата делятся между потоками,
+	// внутри блока k x j строка B добавляется к строке C через axpy
+	Matrix multiply(const Matrix& other, int threads = 0) const {
+		if (cols != other.rows)
+			throw invalid_argument("Matrix dimensions must agree for multiplication");
+
+		Matrix result(rows, other.cols);
+		const int blockK = 256;
+		const int blockJ = max(1, static_cast<int>(simd::paddedCount<T>(2048 / sizeof(T))));
+		const int blockI = 32;
+
+		parallelFor(0, rows, blockI, [&](long long lo, long long hi) {
+			for (int ii = static_cast<int>(lo); ii < hi; ii += blockI) {
+				int iEnd = min<int>(ii + blockI, static_cast<int>(hi));
+				for (int kk = 0; kk < cols; kk += blockK) {
+					int kEnd = min(kk + blockK, cols);
+					for (int jj = 0; jj < other.cols; jj += blockJ) {
+						int jLen = min(blockJ, other.cols - jj);
+						for (int i = ii; i < iEnd; ++i) {
+							const T* a = data + static_cast<size_t>(i) * stride;
+							T* c = result.data + static_cast<size_t>(i) * result.stride + jj;
+							for (int k = kk; k < kEnd; ++k) {
+								simd::axpy(a[k], other.data + static_cast<size_t>(k) * other.stride + jj, c, jLen);
+							}
+						}
+					}
+				}
+			}
+		}, threads);
+		return result;
+	}
+
+	Matrix operator*(const Matrix& other) const { return multiply(other); }
+
+	T* operator[](int row) { return data + static_cast<size_t>(row) * stride; }
+	const T* operator[](int row) const { return data + static_cast<size_t>(row) * stride; }
+	T operator()(int row, int col) const { return data[static_cast<size_t>(row) * stride + col]; }
+	bool aliases(const void* p) const { return p == this; }
+	int getRows() const { return rows; }
+	int getCols() const { return cols; }
+	int getStride() const { return stride; }
+};
+
+template <typename L, typename R>
+MatrixSum<L, R> operator+(const MatrixExpr<L>& l, const MatrixExpr<R>& r) {
+	return MatrixSum<L, R>(l.self(), r.self());
+}
+
+template <typename L, typename R>
+MatrixDiff<L, R> operator-(const MatrixExpr<L>& l, const MatrixExpr<R>& r) {
+	return MatrixDiff<L, R>(l.self(), r.self());
+}
+
+template <typename E>
+MatrixScaled<E> operator*(const MatrixExpr<E>& e, const typename E::value_type& s) {
+	return MatrixScaled<E>(e.self(), s);
+}
+
+template <typename E>
+MatrixScaled<E> operator*(const typename E::value_type& s, const MatrixExpr<E>& e) {
+	return MatrixScaled<E>(e.self(), s);
+}
+
+template <typename E>
+MatrixTransposed<E> transpose(const MatrixExpr<E>& e) {
+	return MatrixTransposed<E>(e.self());
+}
+
+// Произведение ленивым не делается: операнды-выражения вычисляются, затем multiply
+template <typename L, typename R>
+Matrix<typename L::value_type> operator*(const MatrixExpr<L>& l, const MatrixExpr<R>& r) {
+	return Matrix<typename L::value_type>(l).multiply(Matrix<typename R::value_type>(r));
+}
+
+// Пул узлов: память берётся блоками (слэбами), освобождённые узлы уходят
+// в список свободных и переиспользуются. Потокобезопасности нет
+template <typename Node>
+class NodePool {
+private:
+	union Slot {
+		Slot* next;
+		alignas(Node) unsigned char storage[sizeof(Node)];
+	};
+
+	vector<unique_ptr<Slot[]>> slabs;
+	Slot* freeList;
+	size_t nextSlabSize;
+	size_t maxSlabSize;
+
+	void grow() {
+		slabs.emplace_back(new Slot[nextSlabSize]);
+		Slot* slab = slabs.back().get();
+		for (size_t i = 0; i + 1 < nextSlabSize; ++i) {
+			slab[i].next = &slab[i + 1];
+		}
+		slab[nextSlabSize - 1].next = freeList;
+		freeList = slab;
+		nextSlabSize = min(nextSlabSize * 2, maxSlabSize);
+	}
+
+public:
+	NodePool(size_t firstSlab = 64, size_t maxSlab = 65536)
+		: freeList(nullptr), nextSlabSize(max<size_t>(firstSlab, 1)), maxSlabSize(max(firstSlab, maxSlab)) {
+	}
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	void* acquire() {
+		if (!freeList) grow();
+		Slot* slot = freeList;
+		freeList = slot->next;
+		return slot->storage;
+	}
+
+	void release(void* p) {
+		Slot* slot = static_cast<Slot*>(p);
+		slot->next = freeList;
+		freeList = slot;
+	}
+
+	size_t slabCount() const { return slabs.size(); }
+};
+
+// Двусвязный список на узлах из пула. Узел помнит свой пул и возвращается в него,
+// поэтому splice переносит цепочку между любыми списками за O(1), а принявший список
+// держит пулы пришедших узлов живыми. Пул делится явно через List(pool) или через splice:
+// списки с общими пулами - из одного потока. Копия всегда получает собственный пул,
+// перемещённый список - новый при следующей вставке
+template <typename T>
+class List {
+private:
+	struct Node;
+
+public:
+	typedef NodePool<Node> Pool;
+
+private:
+	struct Node {
+		T data;
+		Node* next;
+		Node* prev;
+		Pool* origin;
+		template <typename... Args>
+		Node(Pool* from, Args&&... args) : data(forward<Args>(args)...), next(nullptr), prev(nullptr), origin(from) {}
+	};
+
+public:
+
+	template <typename V>
+	class Iter {
+		friend class List;
+		Node* node;
+		const List* owner;
+		Iter(Node* n, const List* o) : node(n), owner(o) {}
+	public:
+		typedef bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef V* pointer;
+		typedef V& reference;
+
+		Iter() : node(nullptr), owner(nullptr) {}
+		operator Iter<const T>() const { return Iter<const T>(node, owner); }
+
+		V& operator*() const { return node->data; }
+		V* operator->() const { return &node->data; }
+		Iter& operator++() { node = node->next; return *this; }
+		Iter operator++(int) { Iter old = *this; node = node->next; return old; }
+		// --end() даёт последний элемент
+		Iter& operator--() { node = node ? node->prev : owner->tail; return *this; }
+		Iter operator--(int) { Iter old = *this; --*this; return old; }
+		bool operator==(const Iter& other) const { return node == other.node; }
+		bool operator!=(const Iter& other) const { return node != other.node; }
+	};
+
+	typedef Iter<T> iterator;
+	typedef Iter<const T> const_iterator;
+
+private:
+	shared_ptr<Pool> pool;
+	// Чужие пулы, узлы которых могли прийти через splice; отпускаются на clear()
+	vector<shared_ptr<Pool>> borrowed;
+	Node* head;
+	Node* tail;
+	int count;
+
+	template <typename... Args>
+	Node* createNode(Args&&... args) {
+		if (!pool) pool = make_shared<Pool>();
+		void* mem = pool->acquire();
+		try {
+			return ::new (mem) Node(pool.get(), forward<Args>(args)...);
+		}
+		catch (...) {
+			pool->release(mem);
+			throw;
+		}
+	}
+
+	void destroyNode(Node* node) {
+		Pool* origin = node->origin;
+		node->~Node();
+		origin->release(node);
+	}
+
+	// Узлы other могут быть из его пула и из всех, что он сам занял
+	void adoptPools(const List& other) {
+		auto adopt = [&](const shared_ptr<Pool>& p) {
+			if (p && p != pool && find(borrowed.begin(), borrowed.end(), p) == borrowed.end()) borrowed.push_back(p);
+		};
+		adopt(other.pool);
+		for (const auto& p : other.borrowed) adopt(p);
+	}
+
+	// Вставляет цепочку first..last (уже связанную) перед pos; pos == nullptr - в конец
+	void link(Node* pos, Node* first, Node* last) {
+		Node* before = pos ? pos->prev : tail;
+		first->prev = before;
+		last->next = pos;
+		if (before) before->next = first;
+		else head = first;
+		if (pos) pos->prev = last;
+		else tail = last;
+	}
+
+	void unlink(Node* first, Node* last) {
+		if (first->prev) first->prev->next = last->next;
+		else head = last->next;
+		if (last->next) last->next->prev = first->prev;
+		else tail = first->prev;
+	}
+
+public:
+	List() : pool(make_shared<Pool>()), head(nullptr), tail(nullptr), count(0) {}
+
+	explicit List(shared_ptr<Pool> sharedPool) : pool(move(sharedPool)), head(nullptr), tail(nullptr), count(0) {
+		if (!pool) throw invalid_argument("Pool must not be null");
+	}
+
+	List(const List& other) : pool(make_shared<Pool>()), head(nullptr), tail(nullptr), count(0) {
+		for (const T& value : other) pushBack(value);
+	}
+
+	// Узлы уходят вместе с пулом; у other пула нет, пока в него не вставят
+	List(List&& other) noexcept
+		: pool(move(other.pool)), borrowed(move(other.borrowed)), head(other.head), tail(other.tail), count(other.count) {
+		other.head = other.tail = nullptr;
+		other.count = 0;
+	}
+
+	List& operator=(List other) {
+		swap(pool, other.pool);
+		swap(borrowed, other.borrowed);
+		swap(head, other.head);
+		swap(tail, other.tail);
+		swap(count, other.count);
+		return *this;
+	}
+
+	~List() {
+		clear();
+	}
+
+	void pushFront(const T& data) { emplace(begin(), data); }
+	void pushFront(T&& data) { emplace(begin(), move(data)); }
+	void pushBack(const T& data) { emplace(end(), data); }
+	void pushBack(T&& data) { emplace(end(), move(data)); }
+
+	template <typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {
+		Node* newNode = createNode(forward<Args>(args)...);
+		link(pos.node, newNode, newNode);
+		count++;
+		return iterator(newNode, this);
+	}
+
+	iterator insert(const_iterator pos, const T& data) { return emplace(pos, data); }
+
+	iterator erase(const_iterator pos) {
+		Node* node = pos.node;
+		if (!node) throw out_of_range("Cannot erase end()");
+		Node* next = node->next;
+		unlink(node, node);
+		destroyNode(node);
+		count--;
+		return iterator(next, this);
+	}
+
+	void popFront() {
+		if (!head) throw out_of_range("List is empty");
+		erase(begin());
+	}
+
+	void popBack() {
+		if (!tail) throw out_of_range("List is empty");
+		erase(const_iterator(tail, this));
+	}
+
+	void clear() {
+		while (head) {
+			Node* temp = head;
+			head = head->next;
+			destroyNode(temp);
+		}
+		tail = nullptr;
+		count = 0;
+		borrowed.clear();
+	}
+
+	// Переносит все узлы other перед pos за O(1): узлы не копируются и не перевыделяются
+	void splice(const_iterator pos, List& other) {
+		if (&other == this || !other.head) return;
+		adoptPools(other);
+		link(pos.node, other.head, other.tail);
+		count += other.count;
+		other.head = other.tail = nullptr;
+		other.count = 0;
+	}
+
+	// Переносит [first, last) из other перед pos; длина диапазона считается для size()
+	void splice(const_iterator pos, List& other, const_iterator first, const_iterator last) {
+		if (first == last) return;
+		if (&other != this) adoptPools(other);
+		Node* firstNode = first.node;
+		Node* lastNode = last.node ? last.node->prev : other.tail;
+		int moved = 1;
+		for (Node* n = firstNode; n != lastNode; n = n->next) moved++;
+
+		other.unlink(firstNode, lastNode);
+		other.count -= moved;
+		link(pos.node, firstNode, lastNode);
+		count += moved;
+	}
+
+	iterator begin() { return iterator(head, this); }
+	iterator end() { return iterator(nullptr, this); }
+	const_iterator begin() const { return const_iterator(head, this); }
+	const_iterator end() const { return const_iterator(nullptr, this); }
+
+	T& front() { return head->data; }
+	T& back() { return tail->data; }
+	// nullptr у перемещённого списка, в который ещё ничего не вставляли
+	shared_ptr<Pool> getPool() const { return pool; }
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+};
+
+template <typename T>
+class Triangle {
+private:
+	Point<T> p1, p2, p3;
+public:
+	Triangle(const Point<T>& a, const Point<T>& b, const Point<T>& c)
+		: p1(a), p2(b), p3(c) {
+	}
+
+	double area() const {
+		T x1 = p1.getX(), y1 = p1.getY();
+		T x2 = p2.getX(), y2 = p2.getY();
+		T x3 = p3.getX(), y3 = p3.getY();
+
+		return abs((x1 * (y2 - y3) + x2 * (y3 - y1) + x3 * (y1 - y2)) / 2.0);
+	}
+
+	const Point<T>& getP1() const { return p1; }
+	const Point<T>& getP2() const { return p2; }
+	const Point<T>& getP3() const { return p3; }
+};
+
+// Пачка треугольников в виде структуры массивов: ax[], ay[], bx[], by[], cx[], cy[].
+// Так соседние треугольники ложатся в соседние дорожки SIMD-регистра, и площадь,
+// центр, габариты и попадание точки считаются векторно. Для целых T площадь
+// и центр выдаются в double, как у Triangle<T>::area()
+template <typename T>
+class TriangleBatch {
+public:
+	typedef typename conditional<is_floating_point<T>::value, T, double>::type Real;
+
+private:
+	vector<T> coords[6];
+
+	const T* const* columns(const T** v, size_t offset) const {
+		for (int k = 0; k < 6; ++k) v[k] = coords[k].data() + offset;
+		return v;
+	}
+
+	// Куски по grain треугольников, каждый кусок - своим потоком
+	template <typename F>
+	void forChunks(int threads, F fn) const {
+		const long long grain = 1 << 14;
+		parallelFor(0, static_cast<long long>(size()), grain, [&](long long lo, long long hi) {
+			fn(static_cast<size_t>(lo), static_cast<size_t>(hi - lo));
+		}, threads);
+	}
+
+public:
+	TriangleBatch() {}
+
+	explicit TriangleBatch(size_t expected) { reserve(expected); }
+
+	// points - тройки вершин подряд: a0, b0, c0, a1, b1, c1, ...
+	TriangleBatch(const Point<T>* points, size_t triangleCount) {
+		reserve(triangleCount);
+		for (size_t i = 0; i < triangleCount; ++i) add(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+	}
+
+	explicit TriangleBatch(const vector<Triangle<T>>& triangles) {
+		reserve(triangles.size());
+		for (const Triangle<T>& t : triangles) add(t);
+	}
+
+	size_t size() const { return coords[0].size(); }
+	bool empty() const { return coords[0].empty(); }
+
+	void reserve(size_t n) {
+		for (vector<T>& c : coords) c.reserve(n);
+	}
+
+	void clear() {
+		for (vector<T>& c : coords) c.clear();
+	}
+
+	void add(const Point<T>& a, const Point<T>& b, const Point<T>& c) {
+		coords[0].push_back(a.getX()); coords[1].push_back(a.getY());
+		coords[2].push_back(b.getX()); coords[3].push_back(b.getY());
+		coords[4].push_back(c.getX()); coords[5].push_back(c.getY());
+	}
+
+	void add(const Triangle<T>& t) { add(t.getP1(), t.getP2(), t.getP3()); }
+
+	Triangle<T> get(size_t i) const {
+		if (i >= size()) throw out_of_range("Index out of range");
+		return Triangle<T>(Point<T>(coords[0][i], coords[1][i]), Point<T>(coords[2][i], coords[3][i]),
+			Point<T>(coords[4][i], coords[5][i]));
+	}
+
+	// Обратно в тройки вершин подряд
+	vector<Point<T>> toPoints() const {
+		vector<Point<T>> points;
+		points.reserve(3 * size());
+		for (size_t i = 0; i < size(); ++i) {
+			points.emplace_back(coords[0][i], coords[1][i]);
+			points.emplace_back(coords[2][i], coords[3][i]);
+			points.emplace_back(coords[4][i], coords[5][i]);
+		}
+		return points;
+	}
+
+	// Координаты вершин по отдельности: 0 - ax, 1 - ay, 2 - bx, 3 - by, 4 - cx, 5 - cy
+	const T* column(int k) const { return coords[k].data(); }
+
+	// Во все out пишется size() значений; threads = 0 - по числу ядер
+	void area(Real* out, int threads = 0) const {
+		forChunks(threads, [&](size_t from, size_t n) {
+			const T* v[6];
+			if constexpr (is_floating_point<T>::value) simd::triangleArea(columns(v, from), out + from, n);
+			else {
+				columns(v, from);
+				for (size_t i = 0; i < n; ++i) {
+					Real cross = static_cast<Real>(v[2][i] - v[0][i]) * (v[5][i] - v[1][i]) - static_cast<Real>(v[4][i] - v[0][i]) * (v[3][i] - v[1][i]);
+					out[from + i] = abs(cross) / 2.0;
+				}
+			}
+		});
+	}
+
+	void centroid(Real* outX, Real* outY, int threads = 0) const {
+		forChunks(threads, [&](size_t from, size_t n) {
+			const T* v[6];
+			if constexpr (is_floating_point<T>::value) simd::triangleCentroid(columns(v, from), outX + from, outY + from, n);
+			else {
+				columns(v, from);
+				for (size_t i = 0; i < n; ++i) {
+					outX[from + i] = (static_cast<Real>(v[0][i]) + v[2][i] + v[4][i]) / 3.0;
+					outY[from + i] = (static_cast<Real>(v[1][i]) + v[3][i] + v[5][i]) / 3.0;
+				}
+			}
+		});
+	}
+
+	// Габаритные прямоугольники каждого треугольника
+	void aabb(T* minX, T* minY, T* maxX, T* maxY, int threads = 0) const {
+		forChunks(threads, [&](size_t from, size_t n) {
+			const T* v[6];
+			T* out[4] = { minX + from, minY + from, maxX + from, maxY + from };
+			simd::triangleBounds(columns(v, from), out, n);
+		});
+	}
+
+	// inside[i] = 1, если точка лежит в i-м треугольнике или на его границе
+	void contains(const Point<T>& p, uint8_t* inside, int threads = 0) const {
+		forChunks(threads, [&](size_t from, size_t n) {
+			const T* v[6];
+			simd::triangleContains(columns(v, from), p.getX(), p.getY(), inside + from, n);
+		});
+	}
+};
+
+// Граф с вершинами, интернированными в плотные номера 0..n-1.
+// Пока граф изменяется, рёбра лежат в списках смежности; freeze() упаковывает их
+// в CSR (offsets + targets), после чего работают hasEdge за log(deg) и алгоритмы обхода.
+// Правки замороженного графа копятся в дельте и вливаются в CSR фоновым потоком.
+// Граф рассчитан на одного писателя: фоновое слияние читает только неизменяемые снимки
+template <typename T>
+class Graph {
+private:
+	struct Neighbor {
+		int to;
+		double weight;
+	};
+
+	struct Arc {
+		int from;
+		int to;
+		double weight;
+	};
+
+	// CSR: соседи вершины v - targets[offsets[v] .. offsets[v + 1]), отсортированы по номеру
+	struct Csr {
+		size_t vertices = 0;
+		vector<size_t> offsets = vector<size_t>(1, 0);
+		vector<int> targets;
+		vector<double> weights;
+		// Обратный CSR нужен обходу снизу вверх в ориентированном графе
+		vector<size_t> reverseOffsets;
+		vector<int> reverseTargets;
+		size_t selfLoops = 0;
+
+		// Вершины, появившиеся после упаковки, считаются вершинами без рёбер
+		size_t rowBegin(int v) const { return static_cast<size_t>(v) < vertices ? offsets[v] : targets.size(); }
+		size_t rowEnd(int v) const { return static_cast<size_t>(v) < vertices ? offsets[v + 1] : targets.size(); }
+
+		bool find(int s, int d, size_t& at) const {
+			auto first = targets.begin() + rowBegin(s), last = targets.begin() + rowEnd(s);
+			auto it = lower_bound(first, last, d);
+			at = static_cast<size_t>(it - targets.begin());
+			return it != last && *it == d;
+		}
+	};
+
+	struct DeltaEntry {
+		bool removed;
+		double weight;
+	};
+
+	typedef FlatMap<uint64_t, DeltaEntry> Delta;
+
+	bool directed;
+	bool frozen;
+	bool weighted;
+	FlatMap<T, int> ids;
+	vector<T> names;
+
+	// Изменяемое представление: у каждой дуги - её место в списке смежности,
+	// так что повторное ребро лишь обновляет вес, а hasEdge не просматривает список
+	vector<vector<Neighbor>> adjacency;
+	FlatMap<uint64_t, size_t> arcSlots;
+
+	// Замороженное представление: база, дельта в процессе слияния и свежая дельта
+	shared_ptr<const Csr> csr;
+	shared_ptr<const Delta> mergingDelta;
+	Delta delta;
+	future<shared_ptr<const Csr>> pendingMerge;
+	size_t mergeThreshold;
+
+	static uint64_t arcKey(int s, int d) { return (static_cast<uint64_t>(static_cast<uint32_t>(s)) << 32) | static_cast<uint32_t>(d); }
+
+	int intern(const T& vertex) {
+		auto it = ids.find(vertex);
+		if (it != ids.end()) return it->getsecond();
+		int id = static_cast<int>(names.size());
+		ids.emplace(vertex, id);
+		names.push_back(vertex);
+		if (!frozen) adjacency.emplace_back();
+		return id;
+	}
+
+	static void buildReverse(Csr& g) {
+		g.reverseOffsets.assign(g.vertices + 1, 0);
+		for (int t : g.targets) g.reverseOffsets[t + 1]++;
+		for (size_t v = 0; v < g.vertices; ++v) g.reverseOffsets[v + 1] += g.reverseOffsets[v];
+		g.reverseTargets.resize(g.targets.size());
+		vector<size_t> cursor(g.reverseOffsets.begin(), g.reverseOffsets.end() - 1);
+		for (size_t v = 0; v < g.vertices; ++v) {
+			for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+				g.reverseTargets[cursor[g.targets[e]]++] = static_cast<int>(v);
+			}
+		}
+	}
+
+	// Один проход по отсортированным дугам: повторы схлопываются (побеждает последняя), строится CSR
+	static shared_ptr<const Csr> buildCsr(vector<Arc>& arcs, size_t n, bool isDirected, bool isWeighted, int threads) {
+		sorting::stableSampleSort(arcs.begin(), arcs.end(), [](const Arc& a, const Arc& b) {
+			return a.from != b.from ? a.from < b.from : a.to < b.to;
+		}, threads);
+
+		auto g = make_shared<Csr>();
+		g->vertices = n;
+		g->offsets.assign(n + 1, 0);
+		g->targets.reserve(arcs.size());
+		if (isWeighted) g->weights.reserve(arcs.size());
+		for (size_t i = 0; i < arcs.size(); ++i) {
+			if (i + 1 < arcs.size() && arcs[i + 1].from == arcs[i].from && arcs[i + 1].to == arcs[i].to) continue;
+			if (arcs[i].from == arcs[i].to) g->selfLoops++;
+			g->offsets[arcs[i].from + 1]++;
+			g->targets.push_back(arcs[i].to);
+			if (isWeighted) g->weights.push_back(arcs[i].weight);
+		}
+		for (size_t v = 0; v < n; ++v) g->offsets[v + 1] += g->offsets[v];
+		vector<Arc>().swap(arcs);
+		if (isDirected) buildReverse(*g);
+		return g;
+	}
+
+	// Слияние базы с отсортированной дельтой построчно, без пересортировки всей базы
+	static shared_ptr<const Csr> mergeCsr(const Csr& base, const Delta& changes, size_t n, bool isDirected, bool isWeighted) {
+		vector<pair<uint64_t, DeltaEntry>> sorted;
+		sorted.reserve(changes.size());
+		for (const auto& kv : changes) sorted.emplace_back(kv.getfirst(), kv.getsecond());
+		sort(sorted.begin(), sorted.end(), [](const pair<uint64_t, DeltaEntry>& a, const pair<uint64_t, DeltaEntry>& b) {
+			return a.first < b.first;
+		});
+
+		auto g = make_shared<Csr>();
+		g->vertices = n;
+		g->offsets.assign(n + 1, 0);
+		g->targets.reserve(base.targets.size() + sorted.size());
+		if (isWeighted) g->weights.reserve(base.targets.size() + sorted.size());
+		auto emit = [&](int v, int to, double w) {
+			if (v == to) g->selfLoops++;
+			g->targets.push_back(to);
+			if (isWeighted) g->weights.push_back(w);
+		};
+
+		size_t k = 0;
+		for (size_t v = 0; v < n; ++v) {
+			int vi = static_cast<int>(v);
+			size_t e = base.rowBegin(vi), end = base.rowEnd(vi);
+			for (;;) {
+				bool haveDelta = k < sorted.size() && static_cast<int>(sorted[k].first >> 32) == vi;
+				int deltaTo = haveDelta ? static_cast<int>(static_cast<uint32_t>(sorted[k].first)) : 0;
+				if (e < end && (!haveDelta || base.targets[e] < deltaTo)) {
+					emit(vi, base.targets[e], base.weights.empty() ? 1.0 : base.weights[e]);
+					e++;
+				}
+				else if (haveDelta) {
+					if (e < end && base.targets[e] == deltaTo) e++;
+					if (!sorted[k].second.removed) emit(vi, deltaTo, sorted[k].second.weight);
+					k++;
+				}
+				else break;
+			}
+			g->offsets[v + 1] = g->targets.size();
+		}
+		if (isDirected) buildReverse(*g);
+		return g;
+	}
+
+	void installMerge() {
+		if (!pendingMerge.valid()) return;
+		csr = pendingMerge.get();
+		mergingDelta.reset();
+	}
+
+	void pollMerge() {
+		if (pendingMerge.valid() && pendingMerge.wait_for(chrono::seconds(0)) == future_status::ready) installMerge();
+	}
+
+	void startMerge() {
+		installMerge();
+		if (delta.empty()) return;
+		mergingDelta = make_shared<const Delta>(move(delta));
+		delta.clear();
+		shared_ptr<const Csr> base = csr;
+		shared_ptr<const Delta> changes = mergingDelta;
+		size_t n = names.size();
+		bool isDirected = directed, isWeighted = weighted;
+		pendingMerge = async(launch::async, [base, changes, n, isDirected, isWeighted] {
+			return mergeCsr(*base, *changes, n, isDirected, isWeighted);
+		});
+	}
+
+	void recordDelta(int s, int d, bool removed, double weight) {
+		delta[arcKey(s, d)] = { removed, weight };
+		if (!directed) delta[arcKey(d, s)] = { removed, weight };
+		pollMerge();
+		if (delta.size() >= mergeThreshold && !pendingMerge.valid()) startMerge();
+	}
+
+	// Есть ли дуга в замороженном графе с учётом обеих дельт
+	bool frozenHasArc(int s, int d) const {
+		uint64_t key = arcKey(s, d);
+		auto it = delta.find(key);
+		if (it != delta.end()) return !it->getsecond().removed;
+		if (mergingDelta) {
+			auto mit = mergingDelta->find(key);
+			if (mit != mergingDelta->end()) return !mit->getsecond().removed;
+		}
+		size_t at;
+		return csr->find(s, d, at);
+	}
+
+	void insertArc(int s, int d, double weight) {
+		auto slot = arcSlots.emplace(arcKey(s, d), adjacency[s].size());
+		if (slot.second) adjacency[s].push_back({ d, weight });
+		else adjacency[s][slot.first->getsecond()].weight = weight;
+	}
+
+	// Последняя дуга списка переезжает на место удалённой
+	void eraseArc(int s, int d) {
+		auto it = arcSlots.find(arcKey(s, d));
+		if (it == arcSlots.end()) return;
+		size_t at = it->getsecond();
+		arcSlots.erase(arcKey(s, d));
+		vector<Neighbor>& list = adjacency[s];
+		if (at + 1 != list.size()) {
+			list[at] = list.back();
+			arcSlots[arcKey(s, list[at].to)] = at;
+		}
+		list.pop_back();
+	}
+
+	void collectArcs(vector<Arc>& arcs) {
+		if (frozen) {
+			flush();
+			for (size_t v = 0; v < csr->vertices; ++v) {
+				for (size_t e = csr->offsets[v]; e < csr->offsets[v + 1]; ++e) {
+					arcs.push_back({ static_cast<int>(v), csr->targets[e], csr->weights.empty() ? 1.0 : csr->weights[e] });
+				}
+			}
+			return;
+		}
+		for (size_t v = 0; v < adjacency.size(); ++v) {
+			for (const Neighbor& nb : adjacency[v]) arcs.push_back({ static_cast<int>(v), nb.to, nb.weight });
+		}
+	}
+
+	void addArc(vector<Arc>& arcs, const T& src, const T& dest, double weight) {
+		if (weight < 0) throw invalid_argument("Edge weight must be non-negative");
+		int s = intern(src), d = intern(dest);
+		if (weight != 1.0) weighted = true;
+		arcs.push_back({ s, d, weight });
+		if (!directed) arcs.push_back({ d, s, weight });
+	}
+
+	void bulkBuild(vector<Arc>& arcs, int threads) {
+		adjacency.clear();
+		adjacency.shrink_to_fit();
+		arcSlots = FlatMap<uint64_t, size_t>();
+		csr = buildCsr(arcs, names.size(), directed, weighted, threads);
+		frozen = true;
+	}
+
+	// Пакетная загрузка целиком или никак: если fill бросил исключение, вершины,
+	// добавленные им, и флаг весов откатываются, и CSR остаётся согласованным с names
+	template <typename Fill>
+	void bulkLoad(Fill fill, int threads) {
+		size_t mark = names.size();
+		bool wasWeighted = weighted;
+		vector<Arc> arcs;
+		collectArcs(arcs);
+		try {
+			fill(arcs);
+		}
+		catch (...) {
+			for (size_t v = mark; v < names.size(); ++v) ids.erase(names[v]);
+			names.erase(names.begin() + mark, names.end());
+			if (!frozen) adjacency.erase(adjacency.begin() + mark, adjacency.end());
+			weighted = wasWeighted;
+			throw;
+		}
+		bulkBuild(arcs, threads);
+	}
+
+	template <typename V>
+	static bool parseToken(const char* first, const char* last, V& out) {
+		if constexpr (is_integral<V>::value) {
+			return from_chars(first, last, out).ec == errc();
+		}
+		else if constexpr (is_floating_point<V>::value) {
+			string token(first, last);
+			char* end = nullptr;
+			out = static_cast<V>(strtod(token.c_str(), &end));
+			return end != token.c_str();
+		}
+		else if constexpr (is_same<V, string>::value) {
+			out.assign(first, last);
+			return true;
+		}
+		else {
+			istringstream in(string(first, last));
+			return static_cast<bool>(in >> out);
+		}
+	}
+
+	int requireVertex(const T& vertex) const {
+		int id = vertexId(vertex);
+		if (id < 0) throw invalid_argument("Vertex is not in the graph");
+		return id;
+	}
+
+	static int findRoot(vector<atomic<int>>& parent, int v) {
+		// Сжатие путей делением пополам; гонки безвредны - родитель только приближается к корню
+		int p = parent[v].load(memory_order_relaxed);
+		while (p != v) {
+			int gp = parent[p].load(memory_order_relaxed);
+			if (gp != p) parent[v].compare_exchange_weak(p, gp, memory_order_relaxed);
+			v = p;
+			p = parent[v].load(memory_order_relaxed);
+		}
+		return v;
+	}
+
+	// Корень с большим номером подвешивается к меньшему, так что циклов не возникает
+	static void unite(vector<atomic<int>>& parent, int a, int b) {
+		for (;;) {
+			a = findRoot(parent, a);
+			b = findRoot(parent, b);
+			if (a == b) return;
+			if (a < b) swap(a, b);
+			int expected = a;
+			if (parent[a].compare_exchange_strong(expected, b, memory_order_relaxed)) return;
+		}
+	}
+
+public:
+	explicit Graph(bool isDirected = false)
+		: directed(isDirected), frozen(false), weighted(false), csr(make_shared<const Csr>()), mergeThreshold(1 << 16) {
+	}
+
+	~Graph() {
+		if (pendingMerge.valid()) pendingMerge.wait();
+	}
+
+	void addEdge(const T& src, const T& dest, double weight = 1.0) {
+		if (weight < 0) throw invalid_argument("Edge weight must be non-negative");
+		int s = intern(src), d = intern(dest);
+		if (weight != 1.0) weighted = true;
+		if (frozen) {
+			recordDelta(s, d, false, weight);
+			return;
+		}
+		insertArc(s, d, weight);
+		if (!directed) insertArc(d, s, weight); // Для неориентированного графа
+	}
+
+	void removeEdge(const T& src, const T& dest) {
+		int s = vertexId(src), d = vertexId(dest);
+		if (s < 0 || d < 0) return;
+		if (frozen) {
+			recordDelta(s, d, true, 1.0);
+			return;
+		}
+		eraseArc(s, d);
+		if (!directed) eraseArc(d, s);
+	}
+
+	bool hasEdge(const T& src, const T& dest) const {
+		int s = vertexId(src), d = vertexId(dest);
+		if (s < 0 || d < 0) return false;
+		if (frozen) return frozenHasArc(s, d);
+		return arcSlots.contains(arcKey(s, d));
+	}
+
+	// Пакетная загрузка пар (src, dest): все дуги (вместе с уже имеющимися) сортируются
+	// параллельно, повторы схлопываются, CSR строится за один проход. Граф становится замороженным
+	template <typename It>
+	void addEdges(It first, It last, int threads = 0) {
+		bulkLoad([&](vector<Arc>& arcs) {
+			for (; first != last; ++first) addArc(arcs, first->first, first->second, 1.0);
+		}, threads);
+	}
+
+	// Текстовый список рёбер: "src dest [weight]" в строке, строки с # и % пропускаются.
+	// Файл читается блоками по мегабайту, строки разбираются прямо в буфере
+	void loadTextEdgeList(const string& path, int threads = 0) {
+		ifstream in(path, ios::binary);
+		if (!in) throw runtime_error("Cannot open edge list: " + path);
+
+		// Ошибка в середине файла не оставляет графу ни одной вершины из этого файла
+		bulkLoad([&](vector<Arc>& arcs) {
+			const size_t blockSize = 1 << 20;
+			vector<char> buffer(blockSize);
+			string carry;
+			T src, dest;
+
+			auto parseLine = [&](const char* p, const char* end) {
+				const char* fields[3][2];
+				int count = 0;
+				while (p < end && count < 3) {
+					while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) ++p;
+					if (p == end) break;
+					if (count == 0 && (*p == '#' || *p == '%')) return;
+					fields[count][0] = p;
+					while (p < end && *p != ' ' && *p != '\t' && *p != ',' && *p != '\r') ++p;
+					fields[count++][1] = p;
+				}
+				if (count < 2) return;
+				double weight = 1.0;
+				if (!parseToken(fields[0][0], fields[0][1], src) || !parseToken(fields[1][0], fields[1][1], dest) ||
+					(count == 3 && !parseToken(fields[2][0], fields[2][1], weight)))
+					throw runtime_error("Malformed edge list line: " + string(fields[0][0], end));
+				addArc(arcs, src, dest, weight);
+			};
+
+			while (in) {
+				in.read(buffer.data(), blockSize);
+				size_t got = static_cast<size_t>(in.gcount());
+				const char* p = buffer.data();
+				const char* end = p + got;
+				while (p < end) {
+					const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+					if (!nl) {
+						carry.append(p, end);
+						break;
+					}
+					if (!carry.empty()) {
+						carry.append(p, nl);
+						parseLine(carry.data(), carry.data() + carry.size());
+						carry.clear();
+					}
+					else {
+						parseLine(p, nl);
+					}
+					p = nl + 1;
+				}
+			}
+			if (!carry.empty()) parseLine(carry.data(), carry.data() + carry.size());
+		}, threads);
+	}
+
+	// Двоичный список рёбер: подряд идущие пары значений T (src, dest) в памяти как есть
+	void loadBinaryEdgeList(const string& path, int threads = 0) {
+		static_assert(is_trivially_copyable<T>::value, "Binary edge lists need a trivially copyable vertex type");
+		ifstream in(path, ios::binary);
+		if (!in) throw runtime_error("Cannot open edge list: " + path);
+
+		const size_t blockPairs = 1 << 16;
+		vector<T> buffer(blockPairs * 2);
+		bulkLoad([&](vector<Arc>& arcs) {
+			while (in) {
+				in.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(T));
+				size_t pairs = static_cast<size_t>(in.gcount()) / (2 * sizeof(T));
+				for (size_t i = 0; i < pairs; ++i) addArc(arcs, buffer[2 * i], buffer[2 * i + 1], 1.0);
+			}
+		}, threads);
+	}
+
+	// Упаковка в CSR; для замороженного графа - дождаться фонового слияния и влить остаток дельты
+	void freeze(int threads = 0) {
+		if (frozen) {
+			flush();
+			return;
+		}
+		vector<Arc> arcs;
+		collectArcs(arcs);
+		bulkBuild(arcs, threads);
+	}
+
+	void flush() {
+		if (!frozen) return;
+		installMerge();
+		if (delta.empty()) return;
+		csr = mergeCsr(*csr, delta, names.size(), directed, weighted);
+		delta.clear();
+	}
+
+	// Сколько правок копится, прежде чем уйти в фоновое слияние
+	void setMergeThreshold(size_t ops) { mergeThreshold = max<size_t>(ops, 1); }
+
+	bool isFrozen() const { return frozen; }
+	bool isDirected() const { return directed; }
+	int vertexCount() const { return static_cast<int>(names.size()); }
+
+	size_t edgeCount() const {
+		size_t arcs = 0, loops = 0;
+		if (frozen) {
+			arcs = csr->targets.size();
+			loops = csr->selfLoops;
+			// Дельта меняет счёт только там, где итог расходится с базой
+			auto adjust = [&](uint64_t key) {
+				int s = static_cast<int>(key >> 32), d = static_cast<int>(static_cast<uint32_t>(key));
+				size_t at;
+				bool before = csr->find(s, d, at), after = frozenHasArc(s, d);
+				if (before == after) return;
+				if (after) { arcs++; if (s == d) loops++; }
+				else { arcs--; if (s == d) loops--; }
+			};
+			if (mergingDelta) {
+				for (const auto& kv : *mergingDelta) {
+					if (!delta.contains(kv.getfirst())) adjust(kv.getfirst());
+				}
+			}
+			for (const auto& kv : delta) adjust(kv.getfirst());
+		}
+		else {
+			arcs = arcSlots.size();
+			for (size_t v = 0; v < adjacency.size(); ++v) loops += arcSlots.contains(arcKey(static_cast<int>(v), static_cast<int>(v)));
+		}
+		return directed ? arcs : (arcs + loops) / 2;
+	}
+
+	int vertexId(const T& vertex) const {
+		auto it = ids.find(vertex);
+		return it == ids.end() ? -1 : it->getsecond();
+	}
+
+	const T& vertexName(int id) const { return names.at(id); }
+
+	// Обход в ширину с переключением направления (Beamer): пока фронт мал, он
+	// расширяется сверху вниз, а когда рёбер из фронта больше, чем из непосещённых
+	// вершин, каждая непосещённая вершина сама ищет родителя во фронте.
+	// Возвращает расстояния в рёбрах по номерам вершин, -1 - недостижима
+	vector<int> bfs(const T& source, int threads = 0) {
+		freeze(threads);
+		int start = requireVertex(source);
+		const Csr& g = *csr;
+		const vector<size_t>& offsets = g.offsets;
+		const vector<int>& targets = g.targets;
+		size_t n = g.vertices;
+		const size_t alpha = 14, beta = 24;
+		const vector<size_t>& inOff = directed ? g.reverseOffsets : offsets;
+		const vector<int>& inTgt = directed ? g.reverseTargets : targets;
+		if (threads <= 0) threads = hardwareThreads();
+
+		vector<atomic<int>> dist(n);
+		for (auto& d : dist) d.store(-1, memory_order_relaxed);
+		dist[start].store(0, memory_order_relaxed);
+
+		vector<int> frontier(1, start);
+		vector<char> inFrontier(n, 0);
+		size_t unexploredEdges = targets.size();
+		bool bottomUp = false;
+		vector<int> next;
+		mutex nextLock;
+		// Каждый кусок копит найденные вершины у себя и сливает их один раз
+		auto publish = [&](vector<int>& found) {
+			lock_guard<mutex> guard(nextLock);
+			next.insert(next.end(), found.begin(), found.end());
+		};
+
+		for (int level = 0; !frontier.empty(); ++level) {
+			size_t frontierEdges = 0;
+			for (int v : frontier) frontierEdges += offsets[v + 1] - offsets[v];
+			unexploredEdges -= min(unexploredEdges, frontierEdges);
+
+			if (!bottomUp && frontierEdges > unexploredEdges / alpha) bottomUp = true;
+			else if (bottomUp && frontier.size() < n / beta) bottomUp = false;
+
+			next.clear();
+			if (bottomUp) {
+				for (int v : frontier) inFrontier[v] = 1;
+				long long grain = max<long long>(1, static_cast<long long>(n) / threads);
+				parallelFor(0, static_cast<long long>(n), grain, [&](long long lo, long long hi) {
+					vector<int> found;
+					for (long long v = lo; v < hi; ++v) {
+						if (dist[v].load(memory_order_relaxed) != -1) continue;
+						for (size_t e = inOff[v]; e < inOff[v + 1]; ++e) {
+							if (inFrontier[inTgt[e]]) {
+								dist[v].store(level + 1, memory_order_relaxed);
+								found.push_back(static_cast<int>(v));
+								break;
+							}
+						}
+					}
+					publish(found);
+				}, threads);
+				for (int v : frontier) inFrontier[v] = 0;
+			}
+			else {
+				long long grain = max<long long>(64, static_cast<long long>(frontier.size()) / threads);
+				parallelFor(0, static_cast<long long>(frontier.size()), grain, [&](long long lo, long long hi) {
+					vector<int> found;
+					for (long long i = lo; i < hi; ++i) {
+						int u = frontier[i];
+						for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+							int expected = -1;
+							if (dist[targets[e]].compare_exchange_strong(expected, level + 1, memory_order_relaxed)) {
+								found.push_back(targets[e]);
+							}
+						}
+					}
+					publish(found);
+				}, threads);
+			}
+
+			frontier.swap(next);
+		}
+
+		vector<int> result(n);
+		for (size_t v = 0; v < n; ++v) result[v] = dist[v].load(memory_order_relaxed);
+		return result;
+	}
+
+	// Компоненты связности (для ориентированного графа - слабой) через параллельный
+	// union-find. Возвращает метку компоненты по номеру вершины, метки 0..count-1
+	vector<int> connectedComponents(int& count, int threads = 0) {
+		freeze(threads);
+		const Csr& g = *csr;
+		size_t n = g.vertices;
+		vector<atomic<int>> parent(n);
+		for (size_t v = 0; v < n; ++v) parent[v].store(static_cast<int>(v), memory_order_relaxed);
+
+		parallelFor(0, static_cast<long long>(n), 4096, [&](long long lo, long long hi) {
+			for (long long v = lo; v < hi; ++v) {
+				for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+					unite(parent, static_cast<int>(v), g.targets[e]);
+				}
+			}
+		}, threads);
+
+		vector<int> label(n, -1), rootLabel(n, -1);
+		count = 0;
+		for (size_t v = 0; v < n; ++v) {
+			int root = findRoot(parent, static_cast<int>(v));
+			if (rootLabel[root] < 0) rootLabel[root] = count++;
+			label[v] = rootLabel[root];
+		}
+		return label;
+	}
+
+	// Кратчайшие пути по весам рёбер (двоичная куча с ленивым удалением).
+	// Недостижимые вершины получают бесконечность
+	vector<double> dijkstra(const T& source) {
+		freeze();
+		int start = requireVertex(source);
+		const Csr& g = *csr;
+		const double inf = numeric_limits<double>::infinity();
+		vector<double> dist(names.size(), inf);
+		typedef pair<double, int> Item;
+		priority_queue<Item, vector<Item>, greater<Item>> heap;
+		dist[start] = 0;
+		heap.push({ 0.0, start });
+
+		while (!heap.empty()) {
+			Item top = heap.top();
+			heap.pop();
+			int u = top.second;
+			if (top.first > dist[u]) continue;
+			for (size_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+				double candidate = top.first + (g.weights.empty() ? 1.0 : g.weights[e]);
+				if (candidate < dist[g.targets[e]]) {
+					dist[g.targets[e]] = candidate;
+					heap.push({ candidate, g.targets[e] });
+				}
+			}
+		}
+		return dist;
+	}
+};
+
+template <typename T>
+class Cube {
+private:
+	T edgeLength;
+public:
+	Cube(T length) : edgeLength(length) {
+		if (length <= 0) throw invalid_argument("Edge length must be positive");
+	}
+
+	T volume() const {
+		return edgeLength * edgeLength * edgeLength;
+	}
+
+	T surfaceArea() const {
+		return 6 * edgeLength * edgeLength;
+	}
+};
+
+template <typename T>
+class Wrapper {
+private:
+	T value;
+public:
+	Wrapper(const T& val = T()) : value(val) {}
+
+	T get() const { return value; }
+	void set(const T& val) { value = val; }
+
+	operator T() const { return value; }
+	Wrapper& operator=(const T& val) { value = val; return *this; }
 };
\ No newline at end of file
@@ -1,156 +1,276 @@
-#include <iostream>
-#include <vector>
-#include <stdexcept> 
-#include <algorithm> 
-#include <list>
-#include <map>
-#include <set>
-
-using namespace std;
-
-template <typename T> void swapnums(T& a, T& b) {
-	T temp = a;
-	a = b;
-	b = temp;
-}
-
-template <typename T> int minmass(T mass[], int size) {
-	T temp = mass[0];
-	for (int i = 0; i < size; i++) {
-		if (mass[i] < temp) {
-			temp = mass[i];
-		}
-	}
-	return temp;
-}
-
-template <typename T> T arraySum(const T array[], int size) {
-	T sum = 0;
-	for (int i = 0; i < size; i++) {
-		sum += array[i];
-	}
-	return sum;
-}
-
-template <typename T> void copyArr(const T arr1[], T arr2[], int size) {
-	for (int i = 0; i < size; ++i) {
-		arr2[i] = arr1[i];
-	}
-}
-
-template <typename T> void areEqual(const T& a, const T& b) {
-	if (a == b) {
-		cout << " .";
-	}
-	else {
-		cout << "  ";
-	}
-}
-
-template <typename T>
-void reverseArray(T arr[], int size) {
-	for (int i = 0; i < size / 2; ++i) {
-		swap(arr[i], arr[size - 1 - i]);
-	}
-}
-
-template <typename T>
-int findIndex(const T arr[], int size, const T& value) {
-	for (int i = 0; i < size; ++i) {
-		if (arr[i] == value) {
-			return i;
-		}
-	}
-	return -1; // Not found
-}
-
-template <typename T>
-T* mergeArrays(const T arr1[], int size1, const T arr2[], int size2) {
-	T* result = new T[size1 + size2];
-	for (int i = 0; i < size1; ++i) {
-		result[i] = arr1[i];
-	}
-	for (int i = 0; i < size2; ++i) {
-		result[size1 + i] = arr2[i];
-	}
-	return result;
-}
-
-template <typename T>
-double average(const T arr[], int size) {
-	if (size <= 0) throw invalid_argument("Array size must be positive");
-
-	T sum = arraySum(arr, size);
-	return static_cast<double>(sum) / size;
-}
-
-template <typename T, typename Predicate>
-T* filterArray(const T arr[], int size, Predicate pred, int& resultSize) {
-	resultSize = 0;
-	for (int i = 0; i < size; ++i) {
-		if (pred(arr[i])) {
-			resultSize++;
-		}
-	}
-
-	T* result = new T[resultSize];
-	int index = 0;
-	for (int i = 0; i < size; ++i) {
-		if (pred(arr[i])) {
-			result[index++] = arr[i];
-		}
-	}
-
-	return result;
-}
-
-template <typename T>
-T findSecondMax(const T arr[], int size) {
-	if (size < 2) throw invalid_argument("Array must have at least 2 elements");
-
-	T max1 = max(arr[0], arr[1]);
-	T max2 = min(arr[0], arr[1]);
-
-	for (int i = 2; i < size; ++i) {
-		if (arr[i] > max1) {
-			max2 = max1;
-			max1 = arr[i];
-		}
-		else if (arr[i] > max2) {
-			max2 = arr[i];
-		}
-	}
-
-	return max2;
-}
-
-template <typename T> vector<T> arrayToVector(const T arr[], int size) {
-	vector<T> result;
-	for (int i = 0; i < size; ++i) {
-		result.push_back(arr[i]);
-	}
-	return result;
-}
-
-template <typename T> vector<T> arrayIntersection(const T arr1[], int size1, const T arr2[], int size2) {
-	set<T> set1(arr1, arr1 + size1);
-	set<T> set2(arr2, arr2 + size2);
-	vector<T> result;
-
-	set_intersection(set1.begin(), set1.end(),
-		set2.begin(), set2.end(),
-		back_inserter(result));
-
-	return result;
-}
-
-template <typename T>
-void bubbleSort(T arr[], int size) {
-	for (int i = 0; i < size - 1; ++i) {
-		for (int j = 0; j < size - i - 1; ++j) {
-			if (arr[j] > arr[j + 1]) {
-				swap(arr[j], arr[j + 1]);
-			}
-		}
-	}
+#pragma once
+#include <iostream>
+#include <vector>
+#include <stdexcept> 
+#include <algorithm> 
+#include <list>
+#include <map>
+#include <set>
+#include <iterator>
+#include <type_traits>
+#include "Parallel.h"
+#include "SetOps.h"
+#include "Simd.h"
+#include "Sort.h"
+
+using namespace std;
+
+template <typename T> void swapnums(T& a, T& b) {
+	T temp = a;
+	a = b;
+	b = temp;
+}
+
+template <typename T> int minmass(T mass[], int size) {
+	if constexpr (simd::isVectorizable<T>()) {
+		if (size > 0) return simd::minimum(mass, static_cast<size_t>(size));
+	}
+	T temp = mass[0];
+	for (int i = 0; i < size; i++) {
+		if (mass[i] < temp) {
+			temp = mass[i];
+		}
+	}
+	return temp;
+}
+
+template <typename T> T arraySum(const T array[], int size) {
+	if constexpr (simd::isVectorizable<T>()) {
+		return size > 0 ? simd::sum(array, static_cast<size_t>(size)) : T(0);
+	}
+	T sum = 0;
+	for (int i = 0; i < size; i++) {
+		sum += array[i];
+	}
+	return sum;
+}
+
+template <typename T> void copyArr(const T arr1[], T arr2[], int size) {
+	for (int i = 0; i < size; ++i) {
+		arr2[i] = arr1[i];
+	}
+}
+
+template <typename T> void areEqual(const T& a, const T& b) {
+	if (a == b) {
+		cout << "Числа равны.";
+	}
+	else {
+		cout << "Числа не равны";
+	}
+}
+
+template <typename T>
+void reverseArray(T arr[], int size) {
+	for (int i = 0; i < size / 2; ++i) {
+		swap(arr[i], arr[size - 1 - i]);
+	}
+}
+
+template <typename T>
+int findIndex(const T arr[], int size, const T& value) {
+	if constexpr (simd::isVectorizable<T>()) {
+		if (size <= 0) return -1;
+		size_t index = simd::find(arr, static_cast<size_t>(size), value);
+		return index == static_cast<size_t>(size) ? -1 : static_cast<int>(index);
+	}
+	for (int i = 0; i < size; ++i) {
+		if (arr[i] == value) {
+			return i;
+		}
+	}
+	return -1; // Not found
+}
+
+// Дописывает arr1, затем arr2 в out; возвращает позицию за последним записанным
+template <typename T, typename Out>
+Out mergeArrays(const T arr1[], int size1, const T arr2[], int size2, Out out) {
+	out = copy(arr1, arr1 + max(size1, 0), out);
+	return copy(arr2, arr2 + max(size2, 0), out);
+}
+
+template <typename T>
+vector<T> mergeArrays(const T arr1[], int size1, const T arr2[], int size2) {
+	vector<T> result;
+	result.reserve(static_cast<size_t>(max(size1, 0) + max(size2, 0)));
+	mergeArrays(arr1, size1, arr2, size2, back_inserter(result));
+	return result;
+}
+
+template <typename Range1, typename Range2, typename Out>
+Out mergeRanges(const Range1& first, const Range2& second, Out out) {
+	out = copy(std::begin(first), std::end(first), out);
+	return copy(std::begin(second), std::end(second), out);
+}
+
+template <typename T>
+double average(const T arr[], int size) {
+	if (size <= 0) throw invalid_argument("Array size must be positive");
+
+	T sum = arraySum(arr, size);
+	return static_cast<double>(sum) / size;
+}
+
+// Один проход, предикат вызывается один раз на элемент. Для float/double/int32 и
+// предиката simd::lessThan/greaterThan/... выбор идёт векторно (simd::compress)
+template <typename T, typename Predicate, typename Out>
+Out filterArray(const T arr[], int size, Predicate pred, Out out) {
+	if constexpr (simd::isVectorizable<T>() && is_same<Predicate, simd::Compare<T>>::value) {
+		if constexpr (is_same<Out, T*>::value) {
+			return out + simd::compress(arr, static_cast<size_t>(max(size, 0)), pred, out);
+		}
+		else {
+			const int blockSize = 256;
+			T block[blockSize];
+			for (int i = 0; i < size; i += blockSize) {
+				size_t found = simd::compress(arr + i, static_cast<size_t>(min(blockSize, size - i)), pred, block);
+				out = copy(block, block + found, out);
+			}
+			return out;
+		}
+	}
+	else {
+		for (int i = 0; i < size; ++i) {
+			if (pred(arr[i])) {
+				*out++ = arr[i];
+			}
+		}
+		return out;
+	}
+}
+
+template <typename T, typename Predicate>
+vector<T> filterArray(const T arr[], int size, Predicate pred) {
+	vector<T> result;
+	filterArray(arr, size, pred, back_inserter(result));
+	return result;
+}
+
+// Запись в готовый буфер dest[capacity]; возвращает число записанных элементов
+template <typename T, typename Predicate>
+int filterArray(const T arr[], int size, Predicate pred, T dest[], int capacity) {
+	if (capacity >= size) return static_cast<int>(filterArray(arr, size, pred, dest) - dest);
+
+	int count = 0;
+	for (int i = 0; i < size; ++i) {
+		if (pred(arr[i])) {
+			if (count == capacity) throw out_of_range("Destination array is too small");
+			dest[count++] = arr[i];
+		}
+	}
+	return count;
+}
+
+template <typename Range, typename = void>
+struct IsContiguousRange : false_type {};
+
+template <typename Range>
+struct IsContiguousRange<Range, void_t<decltype(std::data(declval<const Range&>())), decltype(std::size(declval<const Range&>()))>> : true_type {};
+
+template <typename Range, typename Predicate, typename Out>
+Out filterRange(const Range& range, Predicate pred, Out out) {
+	if constexpr (IsContiguousRange<Range>::value) {
+		return filterArray(std::data(range), static_cast<int>(std::size(range)), pred, out);
+	}
+	else {
+		for (const auto& item : range) {
+			if (pred(item)) {
+				*out++ = item;
+			}
+		}
+		return out;
+	}
+}
+
+// Каждый кусок фильтруется в своём потоке в локальный буфер, затем по префиксным
+// суммам их размеров куски копируются в dest тоже параллельно. В dest должно быть место под size элементов
+template <typename T, typename Predicate>
+T* parallelFilter(const T arr[], int size, Predicate pred, T dest[], int threads = 0) {
+	if (threads <= 0) threads = hardwareThreads();
+	const int minChunk = 1 << 15;
+	int chunks = max(1, min(threads, size / minChunk));
+	if (chunks == 1) return filterArray(arr, size, pred, dest);
+
+	vector<vector<T>> parts(static_cast<size_t>(chunks));
+	parallelFor(0, chunks, 1, [&](long long lo, long long hi) {
+		for (long long c = lo; c < hi; ++c) {
+			int from = static_cast<int>(size * c / chunks);
+			int to = static_cast<int>(size * (c + 1) / chunks);
+			filterArray(arr + from, to - from, pred, back_inserter(parts[c]));
+		}
+	}, threads);
+
+	vector<size_t> offsets(static_cast<size_t>(chunks) + 1, 0);
+	for (int c = 0; c < chunks; ++c) offsets[c + 1] = offsets[c] + parts[c].size();
+
+	parallelFor(0, chunks, 1, [&](long long lo, long long hi) {
+		for (long long c = lo; c < hi; ++c) copy(parts[c].begin(), parts[c].end(), dest + offsets[c]);
+	}, threads);
+	return dest + offsets[chunks];
+}
+
+template <typename T, typename Predicate>
+vector<T> parallelFilter(const T arr[], int size, Predicate pred, int threads = 0) {
+	vector<T> result(static_cast<size_t>(max(size, 0)));
+	result.resize(static_cast<size_t>(parallelFilter(arr, size, pred, result.data(), threads) - result.data()));
+	return result;
+}
+
+template <typename T>
+T findSecondMax(const T arr[], int size) {
+	if (size < 2) throw invalid_argument("Array must have at least 2 elements");
+	if constexpr (simd::isVectorizable<T>()) {
+		return simd::secondMax(arr, static_cast<size_t>(size));
+	}
+
+	T max1 = max(arr[0], arr[1]);
+	T max2 = min(arr[0], arr[1]);
+
+	for (int i = 2; i < size; ++i) {
+		if (arr[i] > max1) {
+			max2 = max1;
+			max1 = arr[i];
+		}
+		else if (arr[i] > max2) {
+			max2 = arr[i];
+		}
+	}
+
+	return max2;
+}
+
+template <typename T> vector<T> arrayToVector(const T arr[], int size) {
+	vector<T> result;
+	for (int i = 0; i < size; ++i) {
+		result.push_back(arr[i]);
+	}
+	return result;
+}
+
+// Общие элементы без повторов по возрастанию; стратегия (слияние, галоп, хеш) выбирается в SetOps.h
+template <typename T> vector<T> arrayIntersection(const T arr1[], int size1, const T arr2[], int size2,
+	SetStrategy strategy = SetStrategy::Auto) {
+	return setops::intersect(arr1, static_cast<size_t>(max(size1, 0)), arr2, static_cast<size_t>(max(size2, 0)), strategy);
+}
+
+template <typename T> vector<T> arrayIntersection(const vector<vector<T>>& arrays, SetStrategy strategy = SetStrategy::Auto) {
+	vector<pair<const T*, size_t>> inputs;
+	for (const vector<T>& a : arrays) inputs.emplace_back(a.data(), a.size());
+	return setops::intersectAll(inputs, strategy);
+}
+
+template <typename T> vector<T> arrayUnion(const T arr1[], int size1, const T arr2[], int size2) {
+	return setops::unite(arr1, static_cast<size_t>(max(size1, 0)), arr2, static_cast<size_t>(max(size2, 0)));
+}
+
+// Элементы arr1, которых нет в arr2
+template <typename T> vector<T> arrayDifference(const T arr1[], int size1, const T arr2[], int size2,
+	SetStrategy strategy = SetStrategy::Auto) {
+	return setops::difference(arr1, static_cast<size_t>(max(size1, 0)), arr2, static_cast<size_t>(max(size2, 0)), strategy);
+}
+
+// Вместо пузырька: сортировка выбирается по типу и размеру (см. Sort.h)
+template <typename T>
+void sortArray(T arr[], int size, SortPolicy policy = SortPolicy::Auto) {
+	sorting::sort(arr, arr + size, policy);
 }
\ No newline at end of file
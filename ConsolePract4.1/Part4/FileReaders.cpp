@@ -0,0 +1,77 @@
+#include "FileReaders.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void MappedFileReader::close() {
+#ifdef _WIN32
+    if (ptr) UnmapViewOfFile(ptr);
+    if (mapping) CloseHandle(mapping);
+    if (file) CloseHandle(file);
+    file = nullptr;
+    mapping = nullptr;
+#else
+    if (ptr) munmap(const_cast<char*>(ptr), length);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    ptr = nullptr;
+    length = 0;
+}
+
+string_view MappedFileReader::map(const string& filename) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        throw runtime_error("Failed to open mapped file: " + filename);
+    file = handle;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        close();
+        throw runtime_error("Failed to get mapped file size: " + filename);
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    if (length == 0) {
+        close();
+        throw runtime_error("Mapped file is empty: " + filename);
+    }
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw runtime_error("Failed to open mapped file: " + filename);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        throw runtime_error("Failed to get mapped file size: " + filename);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        close();
+        throw runtime_error("Mapped file is empty: " + filename);
+    }
+    void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+        ptr = static_cast<const char*>(p);
+        madvise(p, length, MADV_SEQUENTIAL);
+    }
+#endif
+    if (!ptr) {
+        close();
+        throw runtime_error("Failed to map file: " + filename);
+    }
+    return view();
+}
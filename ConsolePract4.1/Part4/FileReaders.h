@@ -0,0 +1,440 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// windows.h здесь не подключается: из wingdi.h в глобальную область попадают функции Ellipse
+// и Rectangle, которые скрывают одноимённые классы Part4.cpp. Отображение файла - в FileReaders.cpp
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// 2. Класс FileReader с функцией read()
+class FileReader {
+public:
+    virtual string read(const string& filename) = 0;
+    virtual ~FileReader() = default;
+};
+
+class TextFileReader : public FileReader {
+public:
+    // Один read() на весь файл вместо istreambuf_iterator по символу. В текстовом режиме
+    // символов может прийти меньше, чем байт в файле (\r\n в Windows), поэтому размер по gcount()
+    string read(const string& filename) override {
+        ifstream file(filename);
+        if (!file.is_open())
+            throw runtime_error("Failed to open text file: " + filename);
+        file.seekg(0, ios::end);
+        streamoff size = file.tellg();
+        file.seekg(0);
+        string content(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+        file.read(&content[0], static_cast<streamsize>(content.size()));
+        content.resize(static_cast<size_t>(file.gcount()));
+        if (content.empty())
+            throw runtime_error("Text file is empty: " + filename);
+        return content;
+    }
+};
+
+class BinaryFileReader : public FileReader {
+public:
+    string read(const string& filename) override {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open())
+            throw runtime_error("Failed to open binary file: " + filename);
+        file.seekg(0, ios::end);
+        size_t size = file.tellg();
+        if (size == 0)
+            throw runtime_error("Binary file is empty: " + filename);
+        string content(size, '\0');
+        file.seekg(0);
+        file.read(&content[0], size);
+        return content;
+    }
+};
+
+// Файл, отображённый в память. map() отдаёт string_view прямо на страницы файла без копирования,
+// вид живёт до следующего map() или уничтожения читателя. read() оставлен для общего интерфейса и копирует
+class MappedFileReader : public FileReader {
+    const char* ptr = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* file = nullptr; // HANDLE
+    void* mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    void close();
+
+public:
+    MappedFileReader() = default;
+    MappedFileReader(const MappedFileReader&) = delete;
+    MappedFileReader& operator=(const MappedFileReader&) = delete;
+    ~MappedFileReader() override { close(); }
+
+    string_view map(const string& filename);
+
+    string_view view() const { return string_view(ptr, length); }
+
+    // Кусок отображённого файла, тоже без копирования
+    string_view slice(size_t offset, size_t count) const {
+        if (offset > length || count > length - offset)
+            throw out_of_range("Slice is out of range");
+        return string_view(ptr + offset, count);
+    }
+
+    string read(const string& filename) override {
+        return string(map(filename));
+    }
+};
+
+// Чтение блоками заданного размера в один переиспользуемый буфер: память не зависит от размера файла
+class ChunkedFileReader : public FileReader {
+    size_t blockSize;
+
+public:
+    // Курсор по блокам одного файла; блок действителен до следующего next()
+    class Cursor {
+        ifstream file;
+        vector<char> buffer;
+        uint64_t offset = 0;
+
+    public:
+        Cursor(const string& filename, size_t blockSize) : buffer(blockSize) {
+            file.rdbuf()->pubsetbuf(nullptr, 0);
+            file.open(filename, ios::binary);
+            if (!file.is_open())
+                throw runtime_error("Failed to open file: " + filename);
+        }
+
+        bool next(string_view& chunk) {
+            file.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+            size_t got = static_cast<size_t>(file.gcount());
+            if (got == 0) return false;
+            chunk = string_view(buffer.data(), got);
+            offset += got;
+            return true;
+        }
+
+        // Сколько байт уже отдано
+        uint64_t position() const { return offset; }
+    };
+
+    explicit ChunkedFileReader(size_t blockSize = size_t(1) << 20) : blockSize(blockSize) {
+        if (blockSize == 0) throw invalid_argument("Block size must be positive");
+    }
+
+    Cursor open(const string& filename) const { return Cursor(filename, blockSize); }
+
+    template <typename F>
+    void forEachChunk(const string& filename, F fn) const {
+        Cursor cursor = open(filename);
+        string_view chunk;
+        while (cursor.next(chunk)) fn(chunk);
+    }
+
+    string read(const string& filename) override {
+        Cursor cursor = open(filename);
+        string content;
+        ifstream probe(filename, ios::binary | ios::ate);
+        streamoff size = probe.tellg();
+        if (size > 0) content.reserve(static_cast<size_t>(size));
+        string_view chunk;
+        while (cursor.next(chunk)) content.append(chunk.data(), chunk.size());
+        if (content.empty())
+            throw runtime_error("File is empty: " + filename);
+        return content;
+    }
+};
+
+#ifdef __linux__
+// Минимальная обёртка io_uring на системных вызовах, без liburing: кольца отправки и завершений
+// отображаются в память, заявки на чтение кладутся в очередь и уходят в ядро одним io_uring_enter
+class IoUring {
+    int ring = -1;
+    unsigned entries = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+    unsigned queued = 0;
+    unsigned inFlight = 0;
+
+    void close() {
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (ring >= 0) ::close(ring);
+    }
+
+    void fail(const string& what) {
+        int error = errno;
+        close();
+        throw runtime_error(what + ": " + strerror(error));
+    }
+
+public:
+    explicit IoUring(unsigned depth) {
+        io_uring_params params;
+        memset(&params, 0, sizeof params);
+        ring = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+        if (ring < 0) fail("io_uring_setup failed");
+        entries = params.sq_entries;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqRingSize = cqRingSize = max(sqRingSize, cqRingSize);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) fail("io_uring mmap failed");
+        cqRing = single ? sqRing : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) fail("io_uring mmap failed");
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* s = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+        if (s == MAP_FAILED) fail("io_uring mmap failed");
+        sqes = static_cast<io_uring_sqe*>(s);
+
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+    ~IoUring() { close(); }
+
+    unsigned depth() const { return entries; }
+
+    // Заявка на чтение в очередь; false - очередь отправки полна
+    bool queueRead(int fd, void* buffer, unsigned count, uint64_t offset, uint64_t tag) {
+        unsigned tail = *sqTail;
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= entries) return false;
+        unsigned index = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        memset(&sqe, 0, sizeof sqe);
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = count;
+        sqe.off = offset;
+        sqe.user_data = tag;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++queued;
+        ++inFlight;
+        return true;
+    }
+
+    // Отправляет накопленные заявки и ждёт хотя бы waitFor завершений
+    void submit(unsigned waitFor) {
+        for (;;) {
+            long r = syscall(__NR_io_uring_enter, ring, queued, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (r >= 0) {
+                queued -= static_cast<unsigned>(r);
+                return;
+            }
+            if (errno != EINTR) throw runtime_error(string("io_uring_enter failed: ") + strerror(errno));
+        }
+    }
+
+    // Очередное завершение; result - число байт или -errno
+    bool completion(uint64_t& tag, int& result) {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) return false;
+        const io_uring_cqe& cqe = cqes[head & *cqMask];
+        tag = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        --inFlight;
+        return true;
+    }
+
+    // Дожидается всех заявок в полёте: до этого нельзя освобождать их буферы
+    void drain() noexcept {
+        uint64_t tag;
+        int result;
+        while (inFlight > 0) {
+            try {
+                submit(1);
+            }
+            catch (const runtime_error&) {
+                return;
+            }
+            while (completion(tag, result)) {}
+        }
+    }
+};
+
+// Чтение через io_uring: до queueDepth блоков одновременно в полёте, ядро читает их параллельно
+// с обработкой уже пришедших. Если io_uring недоступен (старое ядро, запрет в контейнере) -
+// то же самое через ChunkedFileReader
+class IoUringFileReader : public FileReader {
+    unsigned queueDepth;
+    size_t blockSize;
+
+    struct File {
+        int fd;
+        uint64_t size;
+
+        explicit File(const string& filename) {
+            fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw runtime_error("Failed to open file: " + filename);
+            struct stat info;
+            if (fstat(fd, &info) != 0) {
+                ::close(fd);
+                throw runtime_error("Failed to get file size: " + filename);
+            }
+            size = static_cast<uint64_t>(info.st_size);
+        }
+        ~File() { ::close(fd); }
+    };
+
+    unique_ptr<IoUring> makeRing() const {
+        try {
+            return unique_ptr<IoUring>(new IoUring(queueDepth));
+        }
+        catch (const runtime_error&) {
+            return nullptr;
+        }
+    }
+
+    // Объявляется после буферов: при исключении ждёт чтений в полёте раньше, чем буферы освободятся
+    struct Drain {
+        IoUring& ring;
+        ~Drain() { ring.drain(); }
+    };
+
+    static void check(int result, const string& filename) {
+        if (result < 0)
+            throw runtime_error("Failed to read file: " + filename + ": " + strerror(-result));
+        if (result == 0)
+            throw runtime_error("File was truncated while reading: " + filename);
+    }
+
+public:
+    explicit IoUringFileReader(unsigned queueDepth = 8, size_t blockSize = size_t(1) << 20)
+        : queueDepth(queueDepth), blockSize(blockSize) {
+        if (queueDepth == 0 || blockSize == 0 || blockSize > (size_t(1) << 30))
+            throw invalid_argument("Invalid io_uring reader parameters");
+    }
+
+    static bool available() {
+        try {
+            IoUring ring(1);
+            return true;
+        }
+        catch (const runtime_error&) {
+            return false;
+        }
+    }
+
+    // Весь файл сразу в итоговую строку: каждый блок читается на своё место, без промежуточных буферов
+    string read(const string& filename) override {
+        unique_ptr<IoUring> ring = makeRing();
+        if (!ring) return ChunkedFileReader(blockSize).read(filename);
+        File file(filename);
+        if (file.size == 0)
+            throw runtime_error("File is empty: " + filename);
+        string content(static_cast<size_t>(file.size), '\0');
+        uint64_t blocks = (file.size + blockSize - 1) / blockSize;
+        vector<size_t> done(static_cast<size_t>(blocks), 0);
+        Drain drain{ *ring };
+        uint64_t nextBlock = 0, finished = 0;
+        auto queueBlock = [&](uint64_t b) {
+            uint64_t offset = b * blockSize + done[b];
+            size_t count = static_cast<size_t>(min<uint64_t>(blockSize, file.size - b * blockSize)) - done[b];
+            return ring->queueRead(file.fd, &content[static_cast<size_t>(offset)], static_cast<unsigned>(count), offset, b);
+        };
+
+        while (finished < blocks) {
+            while (nextBlock < blocks && queueBlock(nextBlock)) ++nextBlock;
+            ring->submit(1);
+            uint64_t b;
+            int result;
+            while (ring->completion(b, result)) {
+                check(result, filename);
+                done[b] += static_cast<size_t>(result);
+                size_t want = static_cast<size_t>(min<uint64_t>(blockSize, file.size - b * blockSize));
+                if (done[b] == want) ++finished;
+                else if (!queueBlock(b)) throw runtime_error("io_uring queue overflow");
+            }
+        }
+        return content;
+    }
+
+    // Блоки по порядку в fn(string_view); пока fn обрабатывает блок, следующие уже читаются.
+    // Блок живёт в своём слоте до возврата из fn, затем слот уходит под блок на queueDepth дальше
+    template <typename F>
+    void forEachChunk(const string& filename, F fn) const {
+        unique_ptr<IoUring> ring = makeRing();
+        if (!ring) {
+            ChunkedFileReader(blockSize).forEachChunk(filename, fn);
+            return;
+        }
+        File file(filename);
+        uint64_t blocks = (file.size + blockSize - 1) / blockSize;
+        size_t slots = static_cast<size_t>(min<uint64_t>(ring->depth(), blocks));
+        vector<vector<char>> buffers(slots, vector<char>(static_cast<size_t>(min<uint64_t>(blockSize, file.size))));
+        vector<size_t> done(slots, 0);
+        Drain drain{ *ring };
+        auto length = [&](uint64_t b) { return static_cast<size_t>(min<uint64_t>(blockSize, file.size - b * blockSize)); };
+        auto queueBlock = [&](uint64_t b) {
+            size_t slot = static_cast<size_t>(b % slots);
+            if (!ring->queueRead(file.fd, buffers[slot].data() + done[slot], static_cast<unsigned>(length(b) - done[slot]), b * blockSize + done[slot], b))
+                throw runtime_error("io_uring queue overflow");
+        };
+
+        for (uint64_t b = 0; b < slots; ++b) queueBlock(b);
+        for (uint64_t deliver = 0; deliver < blocks; ++deliver) {
+            size_t slot = static_cast<size_t>(deliver % slots);
+            while (done[slot] < length(deliver)) {
+                ring->submit(1);
+                uint64_t b;
+                int result;
+                while (ring->completion(b, result)) {
+                    check(result, filename);
+                    size_t s = static_cast<size_t>(b % slots);
+                    done[s] += static_cast<size_t>(result);
+                    if (done[s] < length(b)) queueBlock(b);
+                }
+            }
+            fn(string_view(buffers[slot].data(), done[slot]));
+            done[slot] = 0;
+            if (deliver + slots < blocks) queueBlock(deliver + slots);
+        }
+    }
+};
+#endif
@@ -0,0 +1,552 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CSV_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC разрешает AVX-интринсики в любой функции, GCC/Clang - только с атрибутом target
+#if defined(CSV_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CSV_TARGET_AVX2 __attribute__((target("avx2")))
+#define CSV_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define CSV_TARGET_AVX2
+#define CSV_TARGET_SSE2
+#endif
+
+using namespace std;
+
+// Разбор CSV по RFC 4180 в духе simdcsv: блок в 64 байта превращается в битовые маски кавычек,
+// разделителей и переводов строк, маска "внутри кавычек" - префиксный XOR маски кавычек.
+// Разделители и переводы строк вне кавычек - границы полей и записей, остальное не просматривается побайтно
+namespace csv {
+    struct Options {
+        char delimiter = ',';
+        char quote = '"';
+        bool header = true;
+        int threads = 0; // 0 - все ядра
+        size_t chunkBytes = size_t(16) << 20; // кусок одного потока при параллельном разборе
+        size_t streamBlock = size_t(1) << 20;
+    };
+
+    struct BlockMasks {
+        uint64_t quote;
+        uint64_t delimiter;
+        uint64_t newline;
+    };
+
+    // Без инструкции POPCNT: она есть не на всех процессорах с SSE2
+    inline int popCount(uint64_t x) {
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+    }
+
+    inline unsigned lowestBit(uint64_t x) {
+#if defined(_MSC_VER) && defined(_WIN64)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return i;
+#elif defined(_MSC_VER)
+        unsigned long i;
+        if (static_cast<uint32_t>(x)) _BitScanForward(&i, static_cast<uint32_t>(x));
+        else {
+            _BitScanForward(&i, static_cast<uint32_t>(x >> 32));
+            i += 32;
+        }
+        return i;
+#else
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+    }
+
+    // Бит i результата - XOR битов 0..i: единицы от открывающей кавычки до закрывающей
+    inline uint64_t prefixXor(uint64_t x) {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+
+    inline void masksScalar(const unsigned char* p, unsigned char delimiter, unsigned char quote, BlockMasks& m) {
+        m.quote = m.delimiter = m.newline = 0;
+        for (int i = 0; i < 64; ++i) {
+            m.quote |= static_cast<uint64_t>(p[i] == quote) << i;
+            m.delimiter |= static_cast<uint64_t>(p[i] == delimiter) << i;
+            m.newline |= static_cast<uint64_t>(p[i] == '\n') << i;
+        }
+    }
+
+#ifdef CSV_X86
+    CSV_TARGET_SSE2 inline void masksSse2(const unsigned char* p, unsigned char delimiter, unsigned char quote, BlockMasks& m) {
+        __m128i q = _mm_set1_epi8(static_cast<char>(quote));
+        __m128i d = _mm_set1_epi8(static_cast<char>(delimiter));
+        __m128i n = _mm_set1_epi8('\n');
+        m.quote = m.delimiter = m.newline = 0;
+        for (int i = 0; i < 4; ++i) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            m.quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, q)))) << (16 * i);
+            m.delimiter |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, d)))) << (16 * i);
+            m.newline |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, n)))) << (16 * i);
+        }
+    }
+
+    CSV_TARGET_AVX2 inline uint64_t equalBits(__m256i lo, __m256i hi, __m256i c) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, c))))
+            | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, c)))) << 32;
+    }
+
+    CSV_TARGET_AVX2 inline void masksAvx2(const unsigned char* p, unsigned char delimiter, unsigned char quote, BlockMasks& m) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        m.quote = equalBits(lo, hi, _mm256_set1_epi8(static_cast<char>(quote)));
+        m.delimiter = equalBits(lo, hi, _mm256_set1_epi8(static_cast<char>(delimiter)));
+        m.newline = equalBits(lo, hi, _mm256_set1_epi8('\n'));
+    }
+
+    inline bool hasAvx2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool ymmSaved = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        return ymmSaved && (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    typedef void (*MaskFn)(const unsigned char*, unsigned char, unsigned char, BlockMasks&);
+
+    // Выбор реализации один раз за запуск
+    inline MaskFn maskFunction() {
+#ifdef CSV_X86
+        static const MaskFn fn = hasAvx2() ? masksAvx2 : masksSse2;
+#else
+        static const MaskFn fn = masksScalar;
+#endif
+        return fn;
+    }
+
+    // Маски блока с позиции at; хвост короче 64 байт дополняется нулями и обрезается маской
+    inline void blockMasks(const char* data, size_t size, size_t at, const Options& o, BlockMasks& m) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data) + at;
+        unsigned char delimiter = static_cast<unsigned char>(o.delimiter), quote = static_cast<unsigned char>(o.quote);
+        if (size - at >= 64) {
+            maskFunction()(p, delimiter, quote, m);
+            return;
+        }
+        unsigned char tail[64] = {};
+        memcpy(tail, p, size - at);
+        maskFunction()(tail, delimiter, quote, m);
+        uint64_t valid = (uint64_t(1) << (size - at)) - 1;
+        m.quote &= valid;
+        m.delimiter &= valid;
+        m.newline &= valid;
+    }
+
+    [[noreturn]] inline void fail(uint64_t offset, const string& what) {
+        throw runtime_error("Invalid CSV at byte " + to_string(offset) + ": " + what);
+    }
+
+    // Запись: поля - string_view в исходный буфер, а если в поле были удвоенные кавычки - в буфер записи.
+    // Всё действительно только внутри обработчика
+    struct Row {
+        vector<string_view> fields;
+        string_view raw; // запись целиком, без перевода строки
+        uint64_t offset = 0; // смещение записи от начала данных
+
+        size_t size() const { return fields.size(); }
+        string_view operator[](size_t i) const { return fields[i]; }
+    };
+
+    // Поля текущей записи копятся как ссылки: буфер для раскрытых кавычек может переехать,
+    // пока запись не закончена, поэтому string_view собираются только при выдаче
+    class RowBuilder {
+        struct FieldRef {
+            const char* ptr; // nullptr - поле в scratch
+            size_t begin;
+            size_t length;
+        };
+        vector<FieldRef> refs;
+        string scratch;
+        Row row;
+
+    public:
+        void reset() {
+            refs.clear();
+            scratch.clear();
+        }
+
+        // Поле [begin, end) буфера data; last - последнее в записи (перед ним может стоять \r из CRLF)
+        void field(const char* data, size_t begin, size_t end, bool last, uint64_t base, char quote) {
+            if (last && end > begin && data[end - 1] == '\r') --end;
+            const char* p = data + begin;
+            size_t n = end - begin;
+            if (n == 0 || p[0] != quote) {
+                if (n > 0 && memchr(p, quote, n)) fail(base + begin, "quote inside an unquoted field");
+                refs.push_back(FieldRef{ p, 0, n });
+                return;
+            }
+            if (n < 2 || p[n - 1] != quote) fail(base + begin, "unexpected character after a closing quote");
+            const char* inner = p + 1;
+            size_t length = n - 2;
+            const char* q = static_cast<const char*>(memchr(inner, quote, length));
+            if (!q) {
+                refs.push_back(FieldRef{ inner, 0, length });
+                return;
+            }
+            // "" внутри кавычек - одна кавычка; одиночная кавычка внутри - ошибка
+            size_t start = scratch.size();
+            const char* from = inner;
+            const char* stop = inner + length;
+            while (q) {
+                if (q + 1 >= stop || q[1] != quote) fail(base + (q - data), "unescaped quote inside a quoted field");
+                scratch.append(from, q + 1);
+                from = q + 2;
+                q = static_cast<const char*>(memchr(from, quote, stop - from));
+            }
+            scratch.append(from, stop);
+            refs.push_back(FieldRef{ nullptr, start, scratch.size() - start });
+        }
+
+        template <typename F>
+        void emit(const char* record, size_t length, uint64_t offset, F& onRow) {
+            row.fields.resize(refs.size());
+            for (size_t i = 0; i < refs.size(); ++i) {
+                const FieldRef& r = refs[i];
+                row.fields[i] = string_view(r.ptr ? r.ptr : scratch.data() + r.begin, r.length);
+            }
+            if (length > 0 && record[length - 1] == '\r') --length;
+            row.raw = string_view(record, length);
+            row.offset = offset;
+            onRow(static_cast<const Row&>(row));
+            reset();
+        }
+    };
+
+    // Разбор записей data[0, size), начинающихся с начала записи. final - за size больше ничего нет:
+    // последняя запись может быть без перевода строки, незакрытая кавычка - ошибка.
+    // Иначе недописанная последняя запись не выдаётся; возвращается, сколько байт разобрано
+    template <typename F>
+    size_t parseRegion(const char* data, size_t size, uint64_t base, bool final, const Options& o, RowBuilder& b, F& onRow) {
+        uint64_t inside = 0;
+        size_t recordStart = 0, fieldStart = 0;
+        b.reset();
+        for (size_t at = 0; at < size; at += 64) {
+            BlockMasks m;
+            blockMasks(data, size, at, o, m);
+            uint64_t quoted = prefixXor(m.quote) ^ inside;
+            inside = (quoted >> 63) ? ~uint64_t(0) : 0;
+            uint64_t structural = (m.delimiter | m.newline) & ~quoted;
+            while (structural) {
+                unsigned bit = lowestBit(structural);
+                structural &= structural - 1;
+                size_t pos = at + bit;
+                if (!((m.newline >> bit) & 1)) {
+                    b.field(data, fieldStart, pos, false, base, o.quote);
+                    fieldStart = pos + 1;
+                    continue;
+                }
+                // Пустые строки (и одиночный \r) записями не считаются
+                size_t length = pos - recordStart;
+                if (length == 0 || (length == 1 && data[recordStart] == '\r')) b.reset();
+                else {
+                    b.field(data, fieldStart, pos, true, base, o.quote);
+                    b.emit(data + recordStart, length, base + recordStart, onRow);
+                }
+                recordStart = fieldStart = pos + 1;
+            }
+        }
+        if (!final) {
+            b.reset();
+            return recordStart;
+        }
+        if (inside) fail(base + recordStart, "unterminated quoted field");
+        size_t length = size - recordStart;
+        if (length > 0 && !(length == 1 && data[recordStart] == '\r')) {
+            b.field(data, fieldStart, size, true, base, o.quote);
+            b.emit(data + recordStart, length, base + recordStart, onRow);
+        }
+        b.reset();
+        return size;
+    }
+
+    // Однопоточный разбор буфера; onRow(const Row&) для каждой записи, включая заголовок
+    template <typename F>
+    void parse(const char* data, size_t size, const Options& o, F onRow) {
+        RowBuilder b;
+        parseRegion(data, size, 0, true, o, b, onRow);
+    }
+
+    // Потоковый разбор с памятью в несколько блоков: недописанная запись в конце блока
+    // переносится в начало буфера и разбирается заново вместе со следующим
+    template <typename F>
+    void parseStream(istream& in, const Options& o, F onRow) {
+        vector<char> buffer(max<size_t>(o.streamBlock, 64));
+        size_t filled = 0;
+        uint64_t base = 0;
+        RowBuilder b;
+        for (;;) {
+            if (filled == buffer.size()) buffer.resize(buffer.size() * 2);
+            in.read(buffer.data() + filled, static_cast<streamsize>(buffer.size() - filled));
+            filled += static_cast<size_t>(in.gcount());
+            bool final = !in;
+            size_t used = parseRegion(buffer.data(), filled, base, final, o, b, onRow);
+            if (final) return;
+            memmove(buffer.data(), buffer.data() + used, filled - used);
+            filled -= used;
+            base += used;
+        }
+    }
+
+    // Начало первой записи после from: позиция за первым переводом строки вне кавычек в [from, to).
+    // inQuote - внутри ли кавычек байт from. Нет такой границы - to
+    inline size_t nextRecord(const char* data, size_t from, size_t to, bool inQuote, const Options& o) {
+        uint64_t inside = inQuote ? ~uint64_t(0) : 0;
+        for (size_t at = from; at < to; at += 64) {
+            BlockMasks m;
+            blockMasks(data, to, at, o, m);
+            uint64_t quoted = prefixXor(m.quote) ^ inside;
+            inside = (quoted >> 63) ? ~uint64_t(0) : 0;
+            uint64_t newline = m.newline & ~quoted;
+            if (newline) return at + lowestBit(newline) + 1;
+        }
+        return to;
+    }
+
+    inline size_t chunkCount(size_t size, const Options& o) {
+        size_t chunk = max<size_t>(o.chunkBytes, 64);
+        return max<size_t>(1, (size + chunk - 1) / chunk);
+    }
+
+    // Каждый поток берёт куски по очереди; первое исключение из потока пробрасывается после join
+    template <typename F>
+    void runChunks(size_t chunks, int threads, F work) {
+        if (threads <= 0) threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+        size_t workers = min<size_t>(static_cast<size_t>(threads), chunks);
+        atomic<size_t> next(0);
+        exception_ptr error;
+        mutex lock;
+        auto loop = [&] {
+            try {
+                for (size_t c = next++; c < chunks; c = next++) work(c);
+            }
+            catch (...) {
+                lock_guard<mutex> guard(lock);
+                if (!error) error = current_exception();
+                next = chunks;
+            }
+        };
+        vector<thread> pool;
+        for (size_t t = 1; t < workers; ++t) pool.emplace_back(loop);
+        loop();
+        for (auto& t : pool) t.join();
+        if (error) rethrow_exception(error);
+    }
+
+    // Параллельный разбор data[from, size). Проход 1: чётность числа кавычек в каждом куске,
+    // префиксный XOR по кускам даёт состояние "внутри кавычек" на начале каждого куска.
+    // Проход 2: кусок начинается с первой записи после своей границы и разбирается до начала следующего.
+    // onRow(const Row&, size_t chunk) вызывается из разных потоков; внутри куска записи идут по порядку
+    template <typename F>
+    void parseParallel(const char* data, size_t size, const Options& o, F onRow, size_t from = 0) {
+        size_t total = size - from;
+        size_t chunks = chunkCount(total, o);
+        size_t chunk = max<size_t>(o.chunkBytes, 64);
+        if (chunks == 1) {
+            RowBuilder b;
+            auto single = [&](const Row& row) { onRow(row, size_t(0)); };
+            parseRegion(data + from, total, from, true, o, b, single);
+            return;
+        }
+
+        vector<uint8_t> parity(chunks);
+        runChunks(chunks, o.threads, [&](size_t c) {
+            size_t begin = from + c * chunk, end = min(size, begin + chunk);
+            int quotes = 0;
+            for (size_t at = begin; at < end; at += 64) {
+                BlockMasks m;
+                blockMasks(data, end, at, o, m);
+                quotes += popCount(m.quote);
+            }
+            parity[c] = static_cast<uint8_t>(quotes & 1);
+        });
+
+        vector<uint8_t> inQuote(chunks, 0);
+        for (size_t c = 1; c < chunks; ++c) inQuote[c] = inQuote[c - 1] ^ parity[c - 1];
+        vector<size_t> starts(chunks + 1, size);
+        starts[0] = from;
+        runChunks(chunks - 1, o.threads, [&](size_t i) {
+            size_t c = i + 1;
+            size_t begin = from + c * chunk, end = min(size, begin + chunk);
+            starts[c] = nextRecord(data, begin, end, inQuote[c] != 0, o);
+        });
+        // Кусок без границы записи (длинное поле в кавычках) пуст: его начало совпадает со следующим
+        for (size_t c = chunks - 1; c > 0; --c) {
+            size_t end = min(size, from + (c + 1) * chunk);
+            if (starts[c] == end) starts[c] = starts[c + 1];
+        }
+
+        runChunks(chunks, o.threads, [&](size_t c) {
+            if (starts[c] >= starts[c + 1]) return;
+            RowBuilder b;
+            auto handler = [&](const Row& row) { onRow(row, c); };
+            parseRegion(data + starts[c], starts[c + 1] - starts[c], starts[c], starts[c + 1] == size, o, b, handler);
+        });
+    }
+
+    enum class Type { Int, Double, Text };
+
+    struct ColumnSpec {
+        string name; // имя из заголовка, без заголовка - номер столбца с нуля
+        Type type;
+    };
+
+    // Столбец в непрерывных массивах: числа подряд, строки - один буфер и концы строк.
+    // Пустое поле - пропуск (has() == false)
+    class Column {
+        vector<int64_t> ints;
+        vector<double> doubles;
+        string text;
+        vector<uint64_t> ends;
+        vector<uint8_t> present;
+
+    public:
+        string name;
+        Type type = Type::Text;
+
+        size_t size() const { return present.size(); }
+        bool has(size_t i) const { return present[i] != 0; }
+        int64_t intAt(size_t i) const { return ints[i]; }
+        double doubleAt(size_t i) const { return doubles[i]; }
+        string_view textAt(size_t i) const {
+            uint64_t begin = i ? ends[i - 1] : 0;
+            return string_view(text.data() + begin, static_cast<size_t>(ends[i] - begin));
+        }
+        const vector<int64_t>& intValues() const { return ints; }
+        const vector<double>& doubleValues() const { return doubles; }
+
+        void append(string_view field, uint64_t offset) {
+            present.push_back(!field.empty());
+            if (type == Type::Text) {
+                text.append(field.data(), field.size());
+                ends.push_back(text.size());
+                return;
+            }
+            const char* p = field.data();
+            const char* end = p + field.size();
+            if (p != end && *p == '+') ++p;
+            from_chars_result r;
+            if (type == Type::Int) {
+                int64_t x = 0;
+                r = field.empty() ? from_chars_result{ end, errc() } : from_chars(p, end, x);
+                ints.push_back(x);
+            }
+            else {
+                double x = 0;
+                r = field.empty() ? from_chars_result{ end, errc() } : from_chars(p, end, x);
+                doubles.push_back(x);
+            }
+            if (r.ec != errc() || r.ptr != end)
+                fail(offset, "invalid number \"" + string(field) + "\" in column " + name);
+        }
+
+        void append(const Column& other) {
+            ints.insert(ints.end(), other.ints.begin(), other.ints.end());
+            doubles.insert(doubles.end(), other.doubles.begin(), other.doubles.end());
+            uint64_t shift = text.size();
+            text += other.text;
+            for (uint64_t e : other.ends) ends.push_back(e + shift);
+            present.insert(present.end(), other.present.begin(), other.present.end());
+        }
+    };
+
+    struct Table {
+        vector<Column> columns;
+
+        size_t rows() const { return columns.empty() ? 0 : columns[0].size(); }
+
+        const Column& column(const string& name) const {
+            for (const Column& c : columns) if (c.name == name) return c;
+            throw out_of_range("No such column: " + name);
+        }
+    };
+
+    // Нужные столбцы в типизированные массивы; разбор параллельный, у каждого куска своя таблица,
+    // в конце они склеиваются по порядку. Запись с другим числом полей, чем у заголовка, - ошибка
+    inline Table readColumns(const char* data, size_t size, const vector<ColumnSpec>& spec, const Options& o) {
+        size_t from = 0, expected = 0;
+        vector<string> header;
+        if (o.header) {
+            from = nextRecord(data, 0, size, false, o);
+            RowBuilder b;
+            auto take = [&](const Row& row) { header.assign(row.fields.begin(), row.fields.end()); };
+            parseRegion(data, from, 0, true, o, b, take);
+            expected = header.size();
+        }
+
+        vector<size_t> index;
+        size_t needed = 0;
+        for (const ColumnSpec& s : spec) {
+            size_t i = 0;
+            if (o.header) {
+                i = static_cast<size_t>(find(header.begin(), header.end(), s.name) - header.begin());
+                if (i == header.size()) throw invalid_argument("No such column: " + s.name);
+            }
+            else {
+                from_chars_result r = from_chars(s.name.data(), s.name.data() + s.name.size(), i);
+                if (r.ec != errc() || r.ptr != s.name.data() + s.name.size())
+                    throw invalid_argument("Column index expected without header: " + s.name);
+            }
+            index.push_back(i);
+            needed = max(needed, i + 1);
+        }
+
+        Table empty;
+        for (const ColumnSpec& s : spec) {
+            Column c;
+            c.name = s.name;
+            c.type = s.type;
+            empty.columns.push_back(move(c));
+        }
+        vector<Table> parts(chunkCount(size - from, o), empty);
+        parseParallel(data, size, o, [&](const Row& row, size_t chunk) {
+            if (expected ? row.size() != expected : row.size() < needed)
+                fail(row.offset, "expected " + to_string(expected ? expected : needed) + " fields, found " + to_string(row.size()));
+            Table& t = parts[chunk];
+            for (size_t k = 0; k < index.size(); ++k) t.columns[k].append(row.fields[index[k]], row.offset);
+        }, from);
+
+        Table result = move(parts[0]);
+        for (size_t p = 1; p < parts.size(); ++p) {
+            for (size_t k = 0; k < result.columns.size(); ++k) result.columns[k].append(parts[p].columns[k]);
+            parts[p] = Table();
+        }
+        return result;
+    }
+}
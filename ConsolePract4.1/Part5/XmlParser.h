@@ -0,0 +1,607 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Потоковый разбор XML без построения дерева: next() выдаёт события начала и конца элемента,
+// атрибутов и текста. Имена и значения - string_view в скользящий буфер, действительные до
+// следующего next(). Проверяется правильность построения документа (well-formedness)
+namespace xml {
+    enum class EventType { StartElement, Attribute, Text, EndElement, EndDocument };
+
+    struct Event {
+        EventType type = EventType::EndDocument;
+        string_view name; // элемент или атрибут
+        string_view value; // атрибут или текст как в документе, ссылки на сущности не раскрыты
+        bool cdata = false; // текст из <![CDATA[...]]>, раскрывать нечего
+        uint64_t offset = 0; // смещение разметки от начала документа
+    };
+
+    struct Attribute {
+        string_view name;
+        string_view value;
+    };
+
+    [[noreturn]] inline void fail(uint64_t offset, const string& what) {
+        throw runtime_error("Invalid XML at byte " + to_string(offset) + ": " + what);
+    }
+
+    inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    // Имена - ASCII-буквы, цифры, _ : - . и любые не-ASCII символы; цифра, - и . не в начале
+    inline bool isNameStart(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_' || u == ':' || u >= 0x80;
+    }
+
+    inline bool isNameChar(char c) {
+        return isNameStart(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+    }
+
+    inline bool isSpaceOnly(string_view s) {
+        for (char c : s) if (!isSpace(c)) return false;
+        return true;
+    }
+
+    inline void appendUtf8(string& out, uint32_t code) {
+        if (code < 0x80) out += static_cast<char>(code);
+        else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    // Длина ссылки &...; в начале s и её значение; 0 - ссылка неправильная.
+    // Именованные сущности, кроме пяти стандартных, дают code == 0 (их может объявить DOCTYPE)
+    inline size_t entityLength(string_view s, uint32_t& code) {
+        size_t semi = s.find(';');
+        if (semi == string_view::npos || semi < 2) return 0;
+        string_view body = s.substr(1, semi - 1);
+        code = 0;
+        if (body[0] == '#') {
+            bool hex = body.size() > 1 && body[1] == 'x';
+            size_t i = hex ? 2 : 1;
+            if (i == body.size() || body.size() - i > 8) return 0;
+            for (; i < body.size(); ++i) {
+                char c = body[i];
+                uint32_t digit;
+                if (c >= '0' && c <= '9') digit = static_cast<uint32_t>(c - '0');
+                else if (hex && c >= 'a' && c <= 'f') digit = static_cast<uint32_t>(c - 'a' + 10);
+                else if (hex && c >= 'A' && c <= 'F') digit = static_cast<uint32_t>(c - 'A' + 10);
+                else return 0;
+                code = code * (hex ? 16 : 10) + digit;
+            }
+            if (code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return 0;
+            return semi + 1;
+        }
+        if (!isNameStart(body[0])) return 0;
+        for (char c : body) if (!isNameChar(c)) return 0;
+        if (body == "lt") code = '<';
+        else if (body == "gt") code = '>';
+        else if (body == "amp") code = '&';
+        else if (body == "quot") code = '"';
+        else if (body == "apos") code = '\'';
+        return semi + 1;
+    }
+
+    // Текст или значение атрибута с раскрытыми ссылками; необъявленные сущности остаются как есть
+    inline void unescape(string_view s, string& out) {
+        size_t amp = s.find('&');
+        while (amp != string_view::npos) {
+            out.append(s.data(), amp);
+            uint32_t code;
+            size_t n = entityLength(s.substr(amp), code);
+            if (n == 0 || code == 0) {
+                n = n ? n : 1;
+                out.append(s.data() + amp, n);
+            }
+            else appendUtf8(out, code);
+            s.remove_prefix(amp + n);
+            amp = s.find('&');
+        }
+        out.append(s.data(), s.size());
+    }
+
+    inline string unescape(string_view s) {
+        string out;
+        unescape(s, out);
+        return out;
+    }
+
+    struct Options {
+        size_t block = size_t(64) << 10; // размер чтения; длинный текст выдаётся кусками такого размера
+        bool skipWhitespace = true; // не выдавать текст из одних пробелов между элементами
+    };
+
+    class PullParser {
+        istream* in = nullptr;
+        Options options;
+        vector<char> buffer;
+        const char* data = nullptr;
+        size_t pos = 0, end = 0;
+        uint64_t base = 0; // смещение data[0] от начала документа
+        bool eof = false;
+
+        // Стек открытых элементов: имена подряд в одной строке, буфер может сдвигаться
+        string names;
+        vector<size_t> nameEnds;
+        string root;
+        bool rootSeen = false, rootClosed = false, doctype = false;
+        uint64_t prolog = 0; // начало документа после BOM - единственное место для <?xml ...?>
+
+        Event event;
+        vector<Attribute> attrs;
+        size_t nextAttribute = 0;
+        bool pendingEnd = false, popPending = false, started = false;
+
+        uint64_t offsetOf(size_t i) const { return base + i; }
+
+        // Дочитать данные; позиции от pos остаются верными, всё до pos выбрасывается
+        bool fill() {
+            if (!in || eof) return false;
+            if (pos > 0) {
+                memmove(buffer.data(), buffer.data() + pos, end - pos);
+                base += pos;
+                end -= pos;
+                pos = 0;
+            }
+            if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+            in->read(buffer.data() + end, static_cast<streamsize>(buffer.size() - end));
+            size_t got = static_cast<size_t>(in->gcount());
+            end += got;
+            data = buffer.data();
+            if (got == 0) eof = true;
+            return got > 0;
+        }
+
+        // Позиция (от pos) первого вхождения s начиная с from; npos - конец документа
+        size_t find(string_view s, size_t from) {
+            for (;;) {
+                string_view window(data + pos, end - pos);
+                size_t at = window.find(s, from);
+                if (at != string_view::npos) return at;
+                from = max(from, window.size() >= s.size() ? window.size() - s.size() + 1 : size_t(0));
+                if (!fill()) return string_view::npos;
+            }
+        }
+
+        bool has(size_t n) {
+            while (end - pos < n)
+                if (!fill()) return false;
+            return true;
+        }
+
+        bool startsWith(string_view s) {
+            return has(s.size()) && memcmp(data + pos, s.data(), s.size()) == 0;
+        }
+
+        size_t readName(size_t i, size_t limit) const {
+            if (i >= limit || !isNameStart(data[i])) fail(offsetOf(i), "name expected");
+            while (i < limit && isNameChar(data[i])) ++i;
+            return i;
+        }
+
+        void checkReferences(string_view s, uint64_t offset) const {
+            for (size_t amp = s.find('&'); amp != string_view::npos; amp = s.find('&', amp + 1)) {
+                uint32_t code;
+                size_t n = entityLength(s.substr(amp), code);
+                if (n == 0) fail(offset + amp, "invalid character or entity reference");
+                if (code == 0 && !doctype) fail(offset + amp, "undefined entity " + string(s.substr(amp, n)));
+            }
+        }
+
+        string_view top() const {
+            size_t begin = nameEnds.size() > 1 ? nameEnds[nameEnds.size() - 2] : 0;
+            return string_view(names.data() + begin, nameEnds.back() - begin);
+        }
+
+        void pop() {
+            nameEnds.pop_back();
+            names.resize(nameEnds.empty() ? 0 : nameEnds.back());
+            if (nameEnds.empty()) rootClosed = true;
+        }
+
+        // Длина тега от pos до '>' включительно; '>' внутри значений атрибутов не считается
+        size_t tagLength() {
+            char quote = 0;
+            for (size_t i = 1;; ++i) {
+                if (pos + i == end && !fill()) fail(offsetOf(pos), "unterminated tag");
+                char c = data[pos + i];
+                if (quote) {
+                    if (c == quote) quote = 0;
+                }
+                else if (c == '"' || c == '\'') quote = c;
+                else if (c == '>') return i + 1;
+            }
+        }
+
+        const Event& emit(EventType type, string_view name, string_view value, uint64_t offset, bool cdata = false) {
+            event.type = type;
+            event.name = name;
+            event.value = value;
+            event.offset = offset;
+            event.cdata = cdata;
+            return event;
+        }
+
+        const Event& startTag() {
+            uint64_t offset = offsetOf(pos);
+            if (rootClosed) fail(offset, "more than one root element");
+            size_t length = tagLength();
+            size_t limit = pos + length - 1; // позиция '>'
+            bool selfClosing = data[limit - 1] == '/';
+            if (selfClosing) --limit;
+            size_t nameEnd = readName(pos + 1, limit);
+            string_view name(data + pos + 1, nameEnd - pos - 1);
+
+            attrs.clear();
+            size_t i = nameEnd;
+            while (i < limit) {
+                size_t spaceStart = i;
+                while (i < limit && isSpace(data[i])) ++i;
+                if (i == limit) break;
+                if (i == spaceStart) fail(offsetOf(i), "whitespace expected between attributes");
+                size_t attrEnd = readName(i, limit);
+                Attribute a;
+                a.name = string_view(data + i, attrEnd - i);
+                i = attrEnd;
+                while (i < limit && isSpace(data[i])) ++i;
+                if (i == limit || data[i] != '=') fail(offsetOf(i), "'=' expected after attribute " + string(a.name));
+                ++i;
+                while (i < limit && isSpace(data[i])) ++i;
+                if (i == limit || (data[i] != '"' && data[i] != '\'')) fail(offsetOf(i), "quoted attribute value expected");
+                char quote = data[i++];
+                const char* close = static_cast<const char*>(memchr(data + i, quote, limit - i));
+                if (!close) fail(offsetOf(i), "unterminated attribute value");
+                a.value = string_view(data + i, static_cast<size_t>(close - (data + i)));
+                if (a.value.find('<') != string_view::npos) fail(offsetOf(i), "'<' in attribute value");
+                checkReferences(a.value, offsetOf(i));
+                for (const Attribute& other : attrs)
+                    if (other.name == a.name) fail(offsetOf(i), "duplicate attribute " + string(a.name));
+                attrs.push_back(a);
+                i = static_cast<size_t>(close - data) + 1;
+            }
+
+            if (!rootSeen) root = string(name);
+            rootSeen = true;
+            names.append(name.data(), name.size());
+            nameEnds.push_back(names.size());
+            nextAttribute = 0;
+            pendingEnd = selfClosing;
+            pos += length;
+            return emit(EventType::StartElement, name, string_view(), offset);
+        }
+
+        const Event& endTag() {
+            uint64_t offset = offsetOf(pos);
+            size_t length = tagLength();
+            size_t limit = pos + length - 1;
+            size_t nameEnd = readName(pos + 2, limit);
+            for (size_t i = nameEnd; i < limit; ++i)
+                if (!isSpace(data[i])) fail(offsetOf(i), "'>' expected in end tag");
+            string_view name(data + pos + 2, nameEnd - pos - 2);
+            if (nameEnds.empty()) fail(offset, "end tag </" + string(name) + "> without start tag");
+            if (name != top()) fail(offset, "end tag </" + string(name) + "> does not match <" + string(top()) + ">");
+            popPending = true;
+            pos += length;
+            return emit(EventType::EndElement, name, string_view(), offset);
+        }
+
+        // Комментарий, инструкция обработки или DOCTYPE - проверяются и пропускаются; false - это CDATA
+        bool skipMarkup() {
+            uint64_t offset = offsetOf(pos);
+            if (startsWith("<?")) {
+                size_t close = find("?>", 2);
+                if (close == string_view::npos) fail(offset, "unterminated processing instruction");
+                size_t nameEnd = readName(pos + 2, pos + close);
+                string_view target(data + pos + 2, nameEnd - pos - 2);
+                if (target.size() == 3 && (target[0] | 0x20) == 'x' && (target[1] | 0x20) == 'm' && (target[2] | 0x20) == 'l' && offset != prolog)
+                    fail(offset, "XML declaration is allowed only at the start of the document");
+                pos += close + 2;
+                return true;
+            }
+            if (startsWith("<!--")) {
+                size_t close = find("--", 4);
+                if (close == string_view::npos) fail(offset, "unterminated comment");
+                if (!has(close + 3) || data[pos + close + 2] != '>') fail(offsetOf(pos + close), "'--' inside comment");
+                pos += close + 3;
+                return true;
+            }
+            if (startsWith("<![CDATA[")) return false;
+            if (startsWith("<!DOCTYPE")) {
+                if (rootSeen || doctype) fail(offset, "DOCTYPE must come once, before the root element");
+                // Внутреннее подмножество [...] может содержать '>' - считаем скобки и кавычки
+                char quote = 0;
+                int depth = 0;
+                for (size_t i = 9;; ++i) {
+                    if (pos + i == end && !fill()) fail(offset, "unterminated DOCTYPE");
+                    char c = data[pos + i];
+                    if (quote) {
+                        if (c == quote) quote = 0;
+                    }
+                    else if (c == '"' || c == '\'') quote = c;
+                    else if (c == '[') ++depth;
+                    else if (c == ']') --depth;
+                    else if (c == '>' && depth == 0) {
+                        pos += i + 1;
+                        break;
+                    }
+                }
+                doctype = true;
+                return true;
+            }
+            fail(offset, "invalid markup");
+        }
+
+        // Текст до '<'. Если '<' нет в целом блоке, выдаётся кусок блока, не разрывающий ссылку &...;
+        bool text(Event& out) {
+            size_t scanned = 0;
+            size_t length;
+            for (;;) {
+                const char* lt = static_cast<const char*>(memchr(data + pos + scanned, '<', end - pos - scanned));
+                if (lt) {
+                    length = static_cast<size_t>(lt - (data + pos));
+                    break;
+                }
+                scanned = end - pos;
+                if (scanned >= options.block && !nameEnds.empty()) {
+                    length = scanned;
+                    string_view window(data + pos, length);
+                    size_t amp = window.rfind('&');
+                    if (amp != string_view::npos && amp > 0 && window.find(';', amp) == string_view::npos) length = amp;
+                    break;
+                }
+                if (!fill()) {
+                    length = end - pos;
+                    break;
+                }
+            }
+            string_view value(data + pos, length);
+            uint64_t offset = offsetOf(pos);
+            pos += length;
+            if (nameEnds.empty()) {
+                if (!isSpaceOnly(value)) fail(offset, "text outside the root element");
+                return false;
+            }
+            if (value.find("]]>") != string_view::npos) fail(offset + value.find("]]>"), "']]>' in text");
+            checkReferences(value, offset);
+            if (options.skipWhitespace && isSpaceOnly(value)) return false;
+            out.type = EventType::Text;
+            out.name = string_view();
+            out.value = value;
+            out.offset = offset;
+            out.cdata = false;
+            return true;
+        }
+
+    public:
+        // Документ из потока: в памяти только скользящий буфер (растёт лишь под один длинный тег)
+        explicit PullParser(istream& in, const Options& options = Options())
+            : in(&in), options(options), buffer(max<size_t>(options.block, 256)) {
+            data = buffer.data();
+        }
+
+        // Документ целиком в памяти - без копирования
+        PullParser(const char* data, size_t size, const Options& options = Options())
+            : options(options), data(data), end(size), eof(true) {}
+
+        PullParser(const PullParser&) = delete;
+        PullParser& operator=(const PullParser&) = delete;
+
+        // Глубина вложенности: на StartElement и EndElement сам элемент уже (ещё) в стеке
+        size_t depth() const { return nameEnds.size(); }
+
+        string_view name(size_t level) const {
+            size_t begin = level ? nameEnds[level - 1] : 0;
+            return string_view(names.data() + begin, nameEnds[level] - begin);
+        }
+
+        // Имя корневого элемента; пусто, пока он не встретился
+        const string& rootName() const { return root; }
+
+        // Атрибуты текущего начального тега - на StartElement и его событиях Attribute
+        const vector<Attribute>& attributes() const { return attrs; }
+
+        const Event& next() {
+            if (event.type == EventType::EndDocument && started) return event;
+            if (!started && startsWith("\xEF\xBB\xBF")) {
+                pos += 3;
+                prolog = 3;
+            }
+            started = true;
+            if (nextAttribute < attrs.size()) {
+                const Attribute& a = attrs[nextAttribute++];
+                return emit(EventType::Attribute, a.name, a.value, event.offset);
+            }
+            if (pendingEnd) {
+                pendingEnd = false;
+                popPending = true;
+                return emit(EventType::EndElement, top(), string_view(), event.offset);
+            }
+            attrs.clear();
+            nextAttribute = 0;
+            if (popPending) {
+                popPending = false;
+                pop();
+            }
+            for (;;) {
+                if (pos == end && !fill()) {
+                    if (!rootSeen) fail(offsetOf(pos), "no root element");
+                    if (!nameEnds.empty()) fail(offsetOf(pos), "unexpected end of document inside <" + string(top()) + ">");
+                    return emit(EventType::EndDocument, string_view(), string_view(), offsetOf(pos));
+                }
+                if (data[pos] != '<') {
+                    if (text(event)) return event;
+                    continue;
+                }
+                if (!has(2)) fail(offsetOf(pos), "unterminated tag");
+                char c = data[pos + 1];
+                if (c == '/') return endTag();
+                if (c != '?' && c != '!') return startTag();
+                if (skipMarkup()) continue;
+                // CDATA - текст без разметки и ссылок
+                uint64_t offset = offsetOf(pos);
+                if (nameEnds.empty()) fail(offset, "CDATA outside the root element");
+                size_t close = find("]]>", 9);
+                if (close == string_view::npos) fail(offset, "unterminated CDATA section");
+                string_view value(data + pos + 9, close - 9);
+                pos += close + 3;
+                return emit(EventType::Text, string_view(), value, offset, true);
+            }
+        }
+    };
+
+    // Путь в духе XPath: /root/item, //item, /root/*/name, //item/@id, //name/text().
+    // '//' - любое число промежуточных уровней, '*' - любой элемент
+    class Path {
+        struct Step {
+            string name;
+            bool descendant;
+        };
+        vector<Step> steps;
+        string attribute;
+        bool text = false;
+
+        bool match(const PullParser& p, size_t step, size_t level, size_t levels) const {
+            if (step == steps.size()) return level == levels;
+            const Step& s = steps[step];
+            for (size_t l = level; l < levels; ++l) {
+                if ((s.name == "*" || p.name(l) == s.name) && match(p, step + 1, l + 1, levels)) return true;
+                if (!s.descendant) break;
+            }
+            return false;
+        }
+
+    public:
+        explicit Path(string_view expr) {
+            string_view rest = expr;
+            if (rest.empty() || rest[0] != '/') throw invalid_argument("Path must start with '/': " + string(expr));
+            while (!rest.empty()) {
+                bool descendant = rest.size() > 1 && rest[1] == '/';
+                rest.remove_prefix(descendant ? 2 : 1);
+                size_t slash = rest.find('/');
+                string_view step = rest.substr(0, slash);
+                rest = slash == string_view::npos ? string_view() : rest.substr(slash);
+                bool last = rest.empty();
+                if (step.empty()) throw invalid_argument("Empty step in path: " + string(expr));
+                if (step == "text()" || step[0] == '@') {
+                    if (!last || descendant || steps.empty()) throw invalid_argument("text() and @attribute must end the path: " + string(expr));
+                    if (step[0] == '@') attribute = string(step.substr(1));
+                    else text = true;
+                    break;
+                }
+                if (step != "*") {
+                    if (!isNameStart(step[0])) throw invalid_argument("Invalid name in path: " + string(step));
+                    for (char c : step) if (!isNameChar(c)) throw invalid_argument("Invalid name in path: " + string(step));
+                }
+                steps.push_back(Step{ string(step), descendant });
+            }
+            if (steps.empty()) throw invalid_argument("Path has no elements: " + string(expr));
+        }
+
+        bool selectsAttribute() const { return !attribute.empty(); }
+        bool selectsText() const { return text; }
+        const string& attributeName() const { return attribute; }
+
+        // Совпадает ли путь со стеком открытых элементов парсера
+        bool matches(const PullParser& p) const {
+            return match(p, 0, 0, p.depth());
+        }
+    };
+
+    // Поддерево, собранное только для выбранного элемента; текст и атрибуты раскрыты
+    struct Node {
+        string name;
+        vector<pair<string, string>> attributes;
+        string text; // текст прямо внутри элемента, без текста потомков
+        vector<Node> children;
+
+        const string* attribute(string_view key) const {
+            for (const auto& a : attributes) if (a.first == key) return &a.second;
+            return nullptr;
+        }
+
+        const Node* child(string_view key) const {
+            for (const Node& c : children) if (c.name == key) return &c;
+            return nullptr;
+        }
+    };
+
+    // Собрать элемент, на StartElement которого стоит парсер, до его EndElement включительно
+    inline Node readNode(PullParser& p, string_view name) {
+        Node node;
+        node.name = string(name);
+        for (const Attribute& a : p.attributes()) node.attributes.emplace_back(string(a.name), unescape(a.value));
+        for (;;) {
+            const Event& e = p.next();
+            switch (e.type) {
+            case EventType::StartElement:
+                node.children.push_back(readNode(p, e.name));
+                break;
+            case EventType::Text:
+                if (e.cdata) node.text.append(e.value.data(), e.value.size());
+                else unescape(e.value, node.text);
+                break;
+            case EventType::EndElement:
+                return node;
+            default:
+                break;
+            }
+        }
+    }
+
+    // Только совпавшие с путём элементы собираются в Node; остальной документ лишь проверяется
+    template <typename F>
+    void forEachElement(PullParser& p, const Path& path, F onNode) {
+        if (path.selectsAttribute() || path.selectsText()) throw invalid_argument("Path selects values, not elements");
+        for (;;) {
+            const Event& e = p.next();
+            if (e.type == EventType::EndDocument) return;
+            if (e.type == EventType::StartElement && path.matches(p)) {
+                Node node = readNode(p, e.name);
+                onNode(static_cast<const Node&>(node));
+            }
+        }
+    }
+
+    // Значения атрибутов (путь .../@name) или куски текста (путь .../text()) совпавших элементов
+    template <typename F>
+    void forEachValue(PullParser& p, const Path& path, F onValue) {
+        if (!path.selectsAttribute() && !path.selectsText()) throw invalid_argument("Path selects elements, not values");
+        string value;
+        for (;;) {
+            const Event& e = p.next();
+            if (e.type == EventType::EndDocument) return;
+            bool wanted = path.selectsAttribute()
+                ? e.type == EventType::Attribute && e.name == path.attributeName()
+                : e.type == EventType::Text;
+            if (!wanted || !path.matches(p)) continue;
+            if (e.cdata) {
+                onValue(e.value);
+                continue;
+            }
+            value.clear();
+            unescape(e.value, value);
+            onValue(string_view(value));
+        }
+    }
+}
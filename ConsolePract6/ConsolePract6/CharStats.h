@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+using namespace std;
+
+typedef simd::CharClasses CharStats;
+
+namespace charstats {
+	const size_t chunkBytes = size_t(16) << 20;
+
+	// Кодировка строк, прочитанных из консоли: в Windows - кодовая страница ввода консоли
+	// (866 по умолчанию, 1251 после SetConsoleCP(1251)), в остальных системах - UTF-8
+	inline simd::Encoding consoleEncoding() {
+#ifdef _WIN32
+		switch (GetConsoleCP()) {
+		case 866: return simd::Encoding::Cp866;
+		case 65001: return simd::Encoding::Utf8;
+		default: return simd::Encoding::Cp1251;
+		}
+#else
+		return simd::Encoding::Utf8;
+#endif
+	}
+
+	// Один проход по буферу; большие буферы делятся на куски, границы в UTF-8
+	// сдвигаются за байты продолжения, чтобы символ не разрезался
+	inline CharStats count(const char* data, size_t size, simd::Encoding encoding = simd::Encoding::Utf8, int threads = 0) {
+		CharStats total;
+		size_t chunks = (size + chunkBytes - 1) / chunkBytes;
+		if (chunks <= 1) {
+			simd::charClasses(data, size, encoding, total);
+			return total;
+		}
+		vector<size_t> bounds(chunks + 1, size);
+		bounds[0] = 0;
+		for (size_t c = 1; c < chunks; ++c) {
+			size_t at = max(c * chunkBytes, bounds[c - 1]);
+			while (encoding == simd::Encoding::Utf8 && at < size && (static_cast<unsigned char>(data[at]) & 0xC0) == 0x80) ++at;
+			bounds[c] = at;
+		}
+
+		if (threads <= 0) threads = hardwareThreads();
+		atomic<size_t> next(0);
+		mutex lock;
+		parallelFor(0, min<long long>(threads, static_cast<long long>(chunks)), 1, [&](long long, long long) {
+			CharStats local;
+			for (size_t c = next++; c < chunks; c = next++) simd::charClasses(data + bounds[c], bounds[c + 1] - bounds[c], encoding, local);
+			lock_guard<mutex> guard(lock);
+			total.add(local);
+		}, threads);
+		return total;
+	}
+
+	inline CharStats countFile(const string& path, simd::Encoding encoding = simd::Encoding::Utf8, int threads = 0) {
+		MappedFile file(path);
+		return count(file.data(), file.size(), encoding, threads);
+	}
+}
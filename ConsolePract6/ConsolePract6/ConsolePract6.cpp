@@ -1,116 +1,178 @@
-﻿#include <iostream>
-#include "Functions.h"
-
-using namespace std; 
-
-int main()
-{
-    setlocale(LC_ALL, "RU");
-    
-    int zad;
-    cout << "Введите номер задания (1 - 9): ";
-    cin >> zad;
-    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    switch (zad)
-    {
-    case 1: {
-        vector<int> numbers;
-        int temp;
-
-        cout << "Введите числа (любая буква для завершения): " << endl;
-        while (cin >> temp) {
-            numbers.push_back(temp);
-        }
-
-        arraySort(numbers);
-        break;
-    }
-    case 2: {
-        string input;
-        cout << "Введите текст: " << endl;
-        getline(cin, input);
-
-        countVowCons(input);
-        break;
-    }
-    case 3: {
-        vector<string> lines;
-        string line;
-
-        cout << "Введите строки (пустая строка для завершения):\n";
-        while (getline(cin, line) && !line.empty()) {
-            lines.push_back(line);
-        }
-
-        sortSTR(lines);
-        break;
-    }
-    case 4: {
-        int num;
-        cout << "Введите число: ";
-        cin >> num;
-
-        multipTab(num);
-        break;
-    }
-    case 5: {
-        ifstream file("input.txt");
-        if (!file) {
-            cerr << "Ошибка открытия файла" << std::endl;
-            return 1;
-        }
-
-        countSTR(file);
-        break;
-    }
-    case 6: {
-        ifstream file("input.txt");
-        if (!file) {
-            cerr << "Ошибка открытия файла" << std::endl;
-            return 1;
-        }
-
-        unikW(file);
-        break;
-    }
-    case 7: {
-        string input;
-        cout << "Введите строку: ";
-        getline(std::cin, input);
-
-        symb(input);
-        break;
-    }
-    case 8: {
-        vector<std::string> lines;
-        string line;
-        size_t max_len = 0;
-
-        cout << "Введите строки (пустая строка для завершения):\n";
-        while (getline(cin, line) && !line.empty()) {
-            lines.push_back(line);
-            max_len = max(max_len, line.length());
-        }
-
-        tabSTR(lines, max_len);
-    }
-    case 9: {
-        vector<double> numbers;
-        double num; cout << "Введите числа (любая буква для завершения): ";
-
-        while (std::cin >> num) {
-            numbers.push_back(num);
-        }
-
-        if (numbers.empty()) {
-            std::cerr << "Не введено чисел" << std::endl;
-            return 1;
-        }
-
-        stats(numbers);
-    }
-    default:
-        break;
-    }
+#include <iostream>
+#include "Functions.h"
+
+using namespace std; 
+
+int main()
+{
+    setlocale(LC_ALL, "RU");
+    
+    int zad;
+    cout << "Введите номер задания (1 - 12): ";
+    cin >> zad;
+    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    switch (zad)
+    {
+    case 1: {
+        vector<int> numbers;
+        int temp;
+
+        cout << "Введите числа (любая буква для завершения): " << endl;
+        while (cin >> temp) {
+            numbers.push_back(temp);
+        }
+
+        arraySort(numbers);
+        break;
+    }
+    case 2: {
+        string input;
+        cout << "Введите текст: " << endl;
+        getline(cin, input);
+
+        countVowCons(input);
+        break;
+    }
+    case 3: {
+        vector<string> lines;
+        string line;
+
+        cout << "Введите строки (пустая строка для завершения):\n";
+        while (getline(cin, line) && !line.empty()) {
+            lines.push_back(line);
+        }
+
+        sortSTR(lines);
+        break;
+    }
+    case 4: {
+        int num;
+        cout << "Введите число: ";
+        cin >> num;
+
+        multipTab(num);
+        break;
+    }
+    case 5: {
+        string path;
+        cout << "Введите путь к файлу (- для стандартного ввода, пусто - input.txt): ";
+        getline(cin, path);
+        if (path.empty()) path = "input.txt";
+
+        try {
+            countSTR(path, [](uint64_t done, uint64_t total) {
+                if (total > 0) cerr << "\rОбработано: " << done * 100 / total << "%";
+                else cerr << "\rОбработано байт: " << done;
+            });
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        break;
+    }
+    case 6: {
+        string path;
+        cout << "Введите путь к файлу (пусто - input.txt): ";
+        getline(cin, path);
+        if (path.empty()) path = "input.txt";
+
+        try {
+            unikW(path);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        break;
+    }
+    case 7: {
+        string input;
+        cout << "Введите строку: ";
+        getline(std::cin, input);
+
+        symb(input);
+        break;
+    }
+    case 8: {
+        vector<std::string> lines;
+        string line;
+        size_t max_len = 0;
+
+        cout << "Введите строки (пустая строка для завершения):\n";
+        while (getline(cin, line) && !line.empty()) {
+            lines.push_back(line);
+            max_len = max(max_len, report::displayWidth(line, consoleUtf8()));
+        }
+
+        tabSTR(lines, max_len);
+        break;
+    }
+    case 9: {
+        vector<double> numbers;
+        double num; cout << "Введите числа (любая буква для завершения): ";
+
+        while (std::cin >> num) {
+            numbers.push_back(num);
+        }
+
+        if (numbers.empty()) {
+            std::cerr << "Не введено чисел" << std::endl;
+            return 1;
+        }
+
+        stats(numbers);
+        break;
+    }
+    case 10: {
+        string path;
+        cout << "Введите путь к файлу (пусто - input.txt): ";
+        getline(cin, path);
+        if (path.empty()) path = "input.txt";
+
+        try {
+            charStatsFile(path);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        break;
+    }
+    case 11: {
+        string path;
+        cout << "Введите путь к файлу с числами (\"-\" - stdin): ";
+        getline(cin, path);
+
+        try {
+            statsFile(path);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        break;
+    }
+    case 12: {
+        string inPath, outPath, flags;
+        cout << "Введите путь к файлу (\"-\" - stdin): ";
+        getline(cin, inPath);
+        cout << "Введите путь для результата (\"-\" - stdout): ";
+        getline(cin, outPath);
+        cout << "Параметры (--unique --numbers --memory МБ --threads N --temp каталог): ";
+        getline(cin, flags);
+
+        try {
+            sortFile(inPath, outPath, flags);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        break;
+    }
+    default:
+        break;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,542 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Parallel.h"
+#include "Simd.h"
+
+using namespace std;
+
+namespace extsort {
+	struct SortOptions {
+		size_t memoryBudget = size_t(256) << 20; // на строки прогона или на буферы слияния
+		bool unique = false;
+		bool numbers = false; // сортировать как числа double, а не как строки
+		int threads = 0;
+		string tempDir; // пусто - системный каталог временных файлов
+	};
+
+	// "--unique --numbers --memory 512 --threads 4 --temp DIR"; память в мегабайтах
+	inline SortOptions parseOptions(const string& flags) {
+		SortOptions options;
+		istringstream in(flags);
+		string flag;
+		while (in >> flag) {
+			if (flag == "--unique") options.unique = true;
+			else if (flag == "--numbers") options.numbers = true;
+			else if (flag == "--memory" || flag == "--threads" || flag == "--temp") {
+				string value;
+				if (!(in >> value)) throw runtime_error("Missing value for " + flag);
+				if (flag == "--temp") {
+					options.tempDir = value;
+					continue;
+				}
+				long long n = 0;
+				from_chars_result r = from_chars(value.data(), value.data() + value.size(), n);
+				if (r.ec != errc() || r.ptr != value.data() + value.size() || n <= 0) throw runtime_error("Invalid value for " + flag + ": " + value);
+				if (flag == "--memory") options.memoryBudget = static_cast<size_t>(n) << 20;
+				else options.threads = static_cast<int>(n);
+			}
+			else throw runtime_error("Unknown option: " + flag);
+		}
+		return options;
+	}
+
+	const size_t ioBlock = size_t(1) << 20;
+	const size_t minMergeBlock = size_t(64) << 10;
+	const size_t maxMergeBlock = size_t(4) << 20;
+	const size_t maxFanIn = 256;
+
+	// Временный файл прогона; удаляется вместе с объектом
+	class TempFile {
+		string filePath;
+
+	public:
+		TempFile(const string& dir, size_t index) {
+			static const uint64_t tag = random_device()() ^ (uint64_t(random_device()()) << 32);
+			filesystem::path base = dir.empty() ? filesystem::temp_directory_path() : filesystem::path(dir);
+			filePath = (base / ("extsort-" + to_string(tag) + "-" + to_string(index) + ".run")).string();
+		}
+		~TempFile() { remove(filePath.c_str()); }
+
+		TempFile(const TempFile&) = delete;
+		TempFile& operator=(const TempFile&) = delete;
+
+		const string& path() const { return filePath; }
+	};
+
+	// Запись большими блоками вместо построчных operator<<
+	class OutBuffer {
+		ostream& out;
+		string buffer;
+
+	public:
+		explicit OutBuffer(ostream& out) : out(out) { buffer.reserve(ioBlock); }
+
+		// Ошибку записи сообщает только явный flush(), деструктор не бросает
+		~OutBuffer() {
+			if (!buffer.empty()) out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+		}
+
+		void write(const char* p, size_t n) {
+			if (buffer.size() + n > ioBlock) flush();
+			if (n >= ioBlock) out.write(p, static_cast<streamsize>(n));
+			else buffer.append(p, n);
+		}
+
+		void line(string_view s) {
+			write(s.data(), s.size());
+			write("\n", 1);
+		}
+
+		template <typename T>
+		void number(T x) {
+			char text[64];
+			to_chars_result r = to_chars(text, text + sizeof text - 1, x);
+			*r.ptr++ = '\n';
+			write(text, static_cast<size_t>(r.ptr - text));
+		}
+
+		void flush() {
+			if (buffer.empty()) return;
+			out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+			buffer.clear();
+			if (!out) throw runtime_error("Write failed");
+		}
+	};
+
+	// Чтение файла прогона с опережением: пока слияние разбирает один блок,
+	// следующий уже читается в фоне во второй буфер
+	class BlockReader {
+		ifstream file;
+		vector<char> front, back;
+		future<size_t> ahead;
+
+		void prefetch() {
+			ahead = async(launch::async, [this] {
+				file.read(back.data(), static_cast<streamsize>(back.size()));
+				return static_cast<size_t>(file.gcount());
+			});
+		}
+
+	public:
+		BlockReader(const string& path, size_t blockSize) : file(path, ios::binary), front(blockSize), back(blockSize) {
+			if (!file) throw runtime_error("Cannot open file: " + path);
+			prefetch();
+		}
+
+		// Следующий блок в data(); 0 - файл кончился
+		size_t next() {
+			if (!ahead.valid()) return 0;
+			size_t got = ahead.get();
+			swap(front, back);
+			if (got > 0) prefetch();
+			return got;
+		}
+
+		const char* data() const { return front.data(); }
+	};
+
+	// Строки прогона по одной; строка, разрезанная границей блока, склеивается в carry
+	class LineReader {
+		BlockReader blocks;
+		const char* pos = nullptr;
+		const char* end = nullptr;
+		string carry;
+		string_view current;
+
+	public:
+		bool valid = true;
+
+		LineReader(const string& path, size_t blockSize) : blocks(path, blockSize) { advance(); }
+
+		string_view value() const { return current; }
+
+		void advance() {
+			const char* newline = pos ? static_cast<const char*>(memchr(pos, '\n', end - pos)) : nullptr;
+			if (newline) {
+				current = string_view(pos, newline - pos);
+				pos = newline + 1;
+				return;
+			}
+			carry.assign(pos, end);
+			for (;;) {
+				size_t got = blocks.next();
+				if (got == 0) {
+					pos = end = nullptr;
+					valid = !carry.empty();
+					current = carry;
+					return;
+				}
+				pos = blocks.data();
+				end = pos + got;
+				newline = static_cast<const char*>(memchr(pos, '\n', got));
+				if (newline) {
+					carry.append(pos, newline);
+					pos = newline + 1;
+					current = carry;
+					return;
+				}
+				carry.append(pos, end);
+			}
+		}
+	};
+
+	// Числа прогона лежат в двоичном виде; блок кратен sizeof(T), значение не разрезается
+	template <typename T>
+	class BinaryReader {
+		BlockReader blocks;
+		size_t index = 0;
+		size_t count = 0;
+		T current = T();
+
+	public:
+		bool valid = true;
+
+		BinaryReader(const string& path, size_t blockSize) : blocks(path, max(sizeof(T), blockSize / sizeof(T) * sizeof(T))) { advance(); }
+
+		T value() const { return current; }
+
+		void advance() {
+			if (index == count) {
+				count = blocks.next() / sizeof(T);
+				index = 0;
+				if (count == 0) {
+					valid = false;
+					return;
+				}
+			}
+			memcpy(&current, blocks.data() + index++ * sizeof(T), sizeof(T));
+		}
+	};
+
+	// Дерево проигравших: в узлах - проигравшие поединков, победитель в tree[0].
+	// После выдачи победителя переигрывается только путь от его листа, log2(k) сравнений
+	template <typename Reader, typename Less, typename Emit>
+	void mergeRuns(vector<unique_ptr<Reader>>& readers, Less less, Emit emit) {
+		size_t k = readers.size();
+		if (k == 0) return;
+		// Исчерпанный прогон проигрывает всем; при равенстве побеждает прогон с меньшим номером - слияние устойчиво
+		auto better = [&](size_t a, size_t b) {
+			if (!readers[a]->valid) return false;
+			if (!readers[b]->valid) return true;
+			if (less(readers[a]->value(), readers[b]->value())) return true;
+			if (less(readers[b]->value(), readers[a]->value())) return false;
+			return a < b;
+		};
+
+		vector<size_t> tree(k);
+		if (k > 1) {
+			// Узлы 1..k-1 внутренние, k..2k-1 - листья
+			vector<size_t> winner(2 * k);
+			for (size_t leaf = 0; leaf < k; ++leaf) winner[k + leaf] = leaf;
+			for (size_t node = k - 1; node > 0; --node) {
+				size_t a = winner[2 * node], b = winner[2 * node + 1];
+				if (better(a, b)) {
+					winner[node] = a;
+					tree[node] = b;
+				}
+				else {
+					winner[node] = b;
+					tree[node] = a;
+				}
+			}
+			tree[0] = winner[1];
+		}
+
+		while (readers[tree[0]]->valid) {
+			size_t top = tree[0];
+			emit(readers[top]->value());
+			readers[top]->advance();
+			size_t w = top;
+			for (size_t node = (top + k) / 2; node > 0; node /= 2) {
+				if (better(tree[node], w)) swap(tree[node], w);
+			}
+			tree[0] = w;
+		}
+	}
+
+	inline size_t mergeBlock(const SortOptions& options, size_t runs) {
+		return min(maxMergeBlock, max(minMergeBlock, options.memoryBudget / (2 * max<size_t>(runs, 1))));
+	}
+
+	inline size_t fanIn(const SortOptions& options) {
+		return max<size_t>(2, min(maxFanIn, options.memoryBudget / (2 * minMergeBlock)));
+	}
+
+	// Слияние по fanIn прогонов за проход, пока их не останется столько, чтобы слить сразу в вывод
+	template <typename Reader, typename Spill>
+	vector<unique_ptr<TempFile>> reduceRuns(vector<unique_ptr<TempFile>> runs, const SortOptions& options, size_t& nextIndex, Spill spill) {
+		size_t limit = fanIn(options);
+		while (runs.size() > limit) {
+			vector<unique_ptr<TempFile>> merged;
+			for (size_t from = 0; from < runs.size(); from += limit) {
+				size_t to = min(runs.size(), from + limit);
+				if (to - from == 1) {
+					merged.push_back(move(runs[from]));
+					continue;
+				}
+				vector<unique_ptr<Reader>> readers;
+				for (size_t r = from; r < to; ++r) readers.emplace_back(new Reader(runs[r]->path(), mergeBlock(options, to - from)));
+				merged.emplace_back(new TempFile(options.tempDir, nextIndex++));
+				spill(readers, merged.back()->path());
+				readers.clear();
+				for (size_t r = from; r < to; ++r) runs[r].reset();
+			}
+			runs = move(merged);
+		}
+		return runs;
+	}
+
+	// Ключ строки в прогоне: первые 8 байт в порядке big-endian, чтобы большинство
+	// сравнений решалось одним сравнением чисел без обращения к тексту
+	struct LineKey {
+		uint64_t prefix;
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	inline uint64_t linePrefix(const char* p, size_t n) {
+		unsigned char bytes[8] = {};
+		memcpy(bytes, p, min<size_t>(n, 8));
+		uint64_t prefix = 0;
+		for (int i = 0; i < 8; ++i) prefix = (prefix << 8) | bytes[i];
+		return prefix;
+	}
+
+	// Порядок как у std::string: побайтно без знака, затем по длине
+	struct LineLess {
+		const char* text;
+
+		bool operator()(const LineKey& a, const LineKey& b) const {
+			if (a.prefix != b.prefix) return a.prefix < b.prefix;
+			uint32_t n = min(a.length, b.length);
+			if (n > 8) {
+				int c = memcmp(text + a.offset + 8, text + b.offset + 8, n - 8);
+				if (c != 0) return c < 0;
+			}
+			return a.length < b.length;
+		}
+	};
+
+	// Внешняя сортировка строк: прогоны не больше memoryBudget (текст + ключи) сортируются
+	// параллельно и сбрасываются во временные файлы, затем сливаются деревом проигравших.
+	// Вход целиком уместился в память - выводится сразу, без временных файлов
+	inline void sortLines(istream& in, ostream& out, const SortOptions& options = SortOptions()) {
+		const size_t keyCost = sizeof(LineKey) * 3 / 2; // ключ и буфер stable_sort
+		size_t textLimit = min<size_t>(max<size_t>(options.memoryBudget / 2, ioBlock), UINT32_MAX);
+		vector<char> text(min(textLimit, 4 * ioBlock)); // растёт до textLimit, только если вход большой
+		vector<LineKey> keys;
+		vector<unique_ptr<TempFile>> runs;
+		size_t nextIndex = 0, filled = 0;
+		bool eof = false;
+
+		auto writeRun = [&](ostream& to) {
+			OutBuffer buffer(to);
+			const LineKey* last = nullptr;
+			LineLess less{ text.data() };
+			for (const LineKey& key : keys) {
+				if (options.unique && last && !less(*last, key)) continue;
+				buffer.line(string_view(text.data() + key.offset, key.length));
+				last = &key;
+			}
+			buffer.flush();
+		};
+
+		for (;;) {
+			while (!eof) {
+				if (filled == text.size()) {
+					if (text.size() >= textLimit) break;
+					text.resize(min(text.size() * 2, textLimit));
+				}
+				in.read(text.data() + filled, static_cast<streamsize>(min(ioBlock, text.size() - filled)));
+				size_t got = static_cast<size_t>(in.gcount());
+				if (got == 0) eof = true;
+				filled += got;
+			}
+
+			// Целые строки, пока текст прогона и его ключи укладываются в бюджет
+			keys.clear();
+			size_t pos = 0;
+			while (pos < filled) {
+				const char* newline = static_cast<const char*>(memchr(text.data() + pos, '\n', filled - pos));
+				if (!newline && !eof) break;
+				size_t stop = newline ? newline - text.data() : filled;
+				if (!keys.empty() && stop + (keys.size() + 1) * keyCost > options.memoryBudget) break;
+				keys.push_back(LineKey{ linePrefix(text.data() + pos, stop - pos), static_cast<uint32_t>(pos), static_cast<uint32_t>(stop - pos) });
+				pos = newline ? stop + 1 : filled;
+			}
+			if (keys.empty() && pos < filled) {
+				// Строка длиннее буфера - буфер растёт, иначе её не прочитать
+				text.resize(text.size() * 2);
+				continue;
+			}
+
+			parallelSort(keys.begin(), keys.end(), LineLess{ text.data() }, options.threads);
+			bool last = eof && pos == filled;
+			if (last && runs.empty()) {
+				writeRun(out);
+				return;
+			}
+			if (!keys.empty()) {
+				runs.emplace_back(new TempFile(options.tempDir, nextIndex++));
+				ofstream file(runs.back()->path(), ios::binary);
+				if (!file) throw runtime_error("Cannot create temp file: " + runs.back()->path());
+				writeRun(file);
+			}
+			if (last) break;
+			memmove(text.data(), text.data() + pos, filled - pos);
+			filled -= pos;
+		}
+		keys = vector<LineKey>();
+		text = vector<char>();
+
+		auto mergeTo = [&](vector<unique_ptr<LineReader>>& readers, ostream& to) {
+			OutBuffer buffer(to);
+			string previous;
+			bool any = false;
+			mergeRuns(readers, less<string_view>(), [&](string_view line) {
+				if (options.unique) {
+					if (any && line == previous) return;
+					previous.assign(line.data(), line.size());
+					any = true;
+				}
+				buffer.line(line);
+			});
+			buffer.flush();
+		};
+
+		runs = reduceRuns<LineReader>(move(runs), options, nextIndex, [&](vector<unique_ptr<LineReader>>& readers, const string& path) {
+			ofstream file(path, ios::binary);
+			if (!file) throw runtime_error("Cannot create temp file: " + path);
+			mergeTo(readers, file);
+		});
+		vector<unique_ptr<LineReader>> readers;
+		for (auto& run : runs) readers.emplace_back(new LineReader(run->path(), mergeBlock(options, runs.size())));
+		mergeTo(readers, out);
+	}
+
+	// Числа из текста по словам; слово, которое не разбирается целиком, пропускается
+	template <typename T>
+	size_t parseNumbers(const char* p, const char* end, vector<T>& out) {
+		size_t skipped = 0;
+		while (p < end) {
+			while (p < end && simd::isSpaceByte(static_cast<unsigned char>(*p))) ++p;
+			const char* start = p;
+			while (p < end && !simd::isSpaceByte(static_cast<unsigned char>(*p))) ++p;
+			if (start == p) break;
+			if (*start == '+') ++start;
+			T x;
+			from_chars_result r = from_chars(start, p, x);
+			// NaN не упорядочивается и сломал бы сортировку
+			if (r.ec == errc() && r.ptr == p && x == x) out.push_back(x);
+			else ++skipped;
+		}
+		return skipped;
+	}
+
+	// То же для чисел: прогоны - отсортированные массивы T в двоичном виде, вывод - текстом по числу в строке.
+	// Возвращает число пропущенных нечисловых слов
+	template <typename T>
+	size_t sortNumbers(istream& in, ostream& out, const SortOptions& options = SortOptions()) {
+		static_assert(is_arithmetic<T>::value, "sortNumbers needs an arithmetic type");
+		size_t capacity = max<size_t>(options.memoryBudget / (sizeof(T) * 3 / 2 + 1), ioBlock / sizeof(T));
+		vector<T> values;
+		vector<char> block(ioBlock);
+		size_t carry = 0, skipped = 0, nextIndex = 0;
+		vector<unique_ptr<TempFile>> runs;
+
+		auto writeValues = [&](ostream& to) {
+			OutBuffer buffer(to);
+			for (size_t i = 0; i < values.size(); ++i) {
+				if (options.unique && i > 0 && !(values[i - 1] < values[i])) continue;
+				buffer.number(values[i]);
+			}
+			buffer.flush();
+		};
+		auto spillValues = [&] {
+			parallelSort(values.begin(), values.end(), less<T>(), options.threads);
+			runs.emplace_back(new TempFile(options.tempDir, nextIndex++));
+			ofstream file(runs.back()->path(), ios::binary);
+			if (!file) throw runtime_error("Cannot create temp file: " + runs.back()->path());
+			if (options.unique) values.erase(unique(values.begin(), values.end(), [](T a, T b) { return !(a < b); }), values.end());
+			file.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(T)));
+			if (!file) throw runtime_error("Cannot write temp file: " + runs.back()->path());
+			values.clear();
+		};
+
+		// Слово, разрезанное границей блока, переносится в начало следующего
+		for (;;) {
+			if (carry == block.size()) block.resize(block.size() * 2);
+			in.read(block.data() + carry, static_cast<streamsize>(block.size() - carry));
+			size_t got = carry + static_cast<size_t>(in.gcount());
+			bool eof = got == carry;
+			size_t cut = got;
+			while (!eof && cut > 0 && !simd::isSpaceByte(static_cast<unsigned char>(block[cut - 1]))) --cut;
+			skipped += parseNumbers(block.data(), block.data() + cut, values);
+			if (eof) break;
+			carry = got - cut;
+			memmove(block.data(), block.data() + cut, carry);
+			if (values.size() >= capacity) spillValues();
+		}
+
+		if (runs.empty()) {
+			parallelSort(values.begin(), values.end(), less<T>(), options.threads);
+			writeValues(out);
+			return skipped;
+		}
+		if (!values.empty()) spillValues();
+		values = vector<T>();
+
+		auto mergeTo = [&](vector<unique_ptr<BinaryReader<T>>>& readers, auto&& put) {
+			T previous = T();
+			bool any = false;
+			mergeRuns(readers, less<T>(), [&](T x) {
+				if (options.unique) {
+					if (any && !(previous < x)) return;
+					previous = x;
+					any = true;
+				}
+				put(x);
+			});
+		};
+
+		runs = reduceRuns<BinaryReader<T>>(move(runs), options, nextIndex, [&](vector<unique_ptr<BinaryReader<T>>>& readers, const string& path) {
+			ofstream file(path, ios::binary);
+			if (!file) throw runtime_error("Cannot create temp file: " + path);
+			vector<T> chunk;
+			chunk.reserve(ioBlock / sizeof(T));
+			auto flush = [&] {
+				file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<streamsize>(chunk.size() * sizeof(T)));
+				chunk.clear();
+			};
+			mergeTo(readers, [&](T x) {
+				chunk.push_back(x);
+				if (chunk.size() == chunk.capacity()) flush();
+			});
+			flush();
+			if (!file) throw runtime_error("Cannot write temp file: " + path);
+		});
+		vector<unique_ptr<BinaryReader<T>>> readers;
+		for (auto& run : runs) readers.emplace_back(new BinaryReader<T>(run->path(), mergeBlock(options, runs.size())));
+		OutBuffer buffer(out);
+		mergeTo(readers, [&](T x) { buffer.number(x); });
+		buffer.flush();
+		return skipped;
+	}
+}
@@ -1,149 +1,161 @@
-#include <iostream>
-#include <vector>
-#include <algorithm>
-#include <cctype>
-#include <string>
-#include <iomanip>
-#include <fstream>
-#include <set>
-#include <numeric>
-#include <sstream>
-#include <map>
-
-using namespace std;
-
-template <typename T> void arraySort(vector<T> array) {
-	sort(array.begin(), array.end());
-
-	cout << " : " << endl;
-	for (T i : array) {
-		cout << i << " ";
-	}
-}
-
-void countVowCons(string some) {
-	int vowels = 0, consonants = 0;
-	some.erase(remove(some.begin(), some.end(), ' '));
-
-	for (char z : some) {
-		if (isalpha(z)) {
-			z = tolower(z);
-			if (z == 'a' || z == 'e' || z == 'i' || z == 'o' || z == 'u') {
-				vowels++;
-			}
-			else {
-				consonants++;
-			}
-		}
-	}
-
-	cout << ": " << vowels << "\n" << ": " << consonants;
-}
-
-void sortSTR(vector<string> lnr) {
-	sort(lnr.begin(), lnr.end());
-	cout << "\n :\n";
-	for (const auto& l : lnr) {
-		cout << setw(20) << left << l << endl;
-	}
-}
-
-void multipTab(int num) {
-	cout << "   " << num << ":\n";
-	for (int i = 1; i <= 10; ++i) {
-		cout << setw(2) << num << " x " << setw(2) << i << " = " << setw(3) << num * i << endl;
-	}
-}
-
-void countSTR(ifstream& file) {
-	int lines = 0, words = 0, chars = 0;
-	string line;
-
-	while (getline(file, line)) {
-		lines++;
-		chars += line.length();
-		chars += lines;
-
-		istringstream iss(line);
-		string word;
-		while (iss >> word) {
-			words++;
-		}
-	}
-
-	cout << ": " << lines << "\n: " << words << "\n: " << chars << endl;
-}
-
-string normalize(const string& word) {
-	string result;
-	for (char c : word) {
-		if (isalpha(c)) {
-			result += tolower(c);
-		}
-	}
-	return result;
-}
-
-void unikW(ifstream& file) {
-	set<string> unique_words;
-	string word;
-
-	while (file >> word) {
-		word = normalize(word);
-		if (!word.empty()) {
-			unique_words.insert(word);
-		}
-	}
-	cout << " :\n";
-	for (const auto& w : unique_words) {
-		cout << w << endl;
-	}
-}
-
-void symb(string input) {
-	int chars = 0, spaces = 0, punct = 0;
-
-	for (char c : input) {
-		chars++;
-		if (isspace(c)) {
-			spaces++;
-		}
-		else if (ispunct(c)) {
-			punct++;
-		}
-	}
-
-	cout << left << setw(15) << ":" << chars << '\n' << setw(15) << ":" << spaces << '\n' << setw(15) << " :" << punct << endl;
-}
-
-void tabSTR(vector<string> lnr, size_t max_len) {
-	for (const auto& l : lnr) {
-		cout << setw(max_len) << right << l << endl;
-	}
-}
-
-void stats(vector<double> numbers) {
-	double sum = std::accumulate(numbers.begin(), numbers.end(), 0.0);
-	double mean = sum / numbers.size();
-
-	sort(numbers.begin(), numbers.end());
-	double median = numbers.size() % 2 == 0 ?
-		(numbers[numbers.size() / 2 - 1] + numbers[numbers.size() / 2]) / 2 :
-		numbers[numbers.size() / 2];
-
-	map<double, int> counts;
-	for (double n : numbers) {
-		counts[n]++;
-	}
-	double mode = numbers[0];
-	int max_count = 0;
-	for (const auto& pair : counts) {
-		if (pair.second > max_count) {
-			max_count = pair.second;
-			mode = pair.first;
-		}
-	}
-
-	cout << std::fixed << std::setprecision(2);
-	cout << ": " << mean << "\n: " << median << "\n: " << mode << endl;
-}
\ No newline at end of file
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <iomanip>
+#include <fstream>
+#include <set>
+#include <numeric>
+#include <sstream>
+#include "CharStats.h"
+#include "ExternalSort.h"
+#include "Statistics.h"
+#include "TableWriter.h"
+#include "Vocabulary.h"
+#include "WordCount.h"
+
+using namespace std;
+
+template <typename T> void arraySort(vector<T> array) {
+	sort(array.begin(), array.end());
+
+	cout << "Отсортированный массив: " << endl;
+	for (T i : array) {
+		cout << i << " ";
+	}
+}
+
+// Строка из консоли - в кодировке консоли (CP866/CP1251 в Windows): русские буквы тоже гласные и согласные
+void countVowCons(const string& some) {
+	CharStats stats = charstats::count(some.data(), some.size(), charstats::consoleEncoding());
+
+	cout << "Гласных: " << stats.vowels << "\n" << "Согласных: " << stats.consonants;
+}
+
+// Строки из консоли в UTF-8 только вне Windows или после chcp 65001, иначе ширина - в байтах
+inline bool consoleUtf8() {
+	return charstats::consoleEncoding() == simd::Encoding::Utf8;
+}
+
+void sortSTR(vector<string> lnr, ostream& out = cout, bool utf8 = consoleUtf8()) {
+	sort(lnr.begin(), lnr.end());
+	report::TableWriter table(out, { { 20, report::Align::Left } }, utf8);
+	table.text("\nОтсортированные строки:").endRow();
+	for (const auto& l : lnr) {
+		table.cell(l).endRow();
+	}
+	table.flush();
+}
+
+// Сортировка файла любого размера с ограниченной памятью; "-" - stdin/stdout.
+// flags - параметры extsort::parseOptions: --unique, --numbers, --memory МБ, --threads N, --temp каталог
+void sortFile(const string& inPath, const string& outPath, const string& flags = "") {
+	extsort::SortOptions options = extsort::parseOptions(flags);
+	ifstream inFile;
+	ofstream outFile;
+	if (inPath != "-") {
+		inFile.open(inPath, ios::binary);
+		if (!inFile) throw runtime_error("Cannot open file: " + inPath);
+	}
+	if (outPath != "-") {
+		outFile.open(outPath, ios::binary);
+		if (!outFile) throw runtime_error("Cannot create file: " + outPath);
+	}
+	istream& in = inPath == "-" ? cin : inFile;
+	ostream& out = outPath == "-" ? cout : outFile;
+
+	if (options.numbers) {
+		size_t skipped = extsort::sortNumbers<double>(in, out, options);
+		if (skipped) cerr << "Пропущено не чисел: " << skipped << endl;
+	}
+	else extsort::sortLines(in, out, options);
+}
+
+void multipTab(int num, ostream& out = cout) {
+	report::TableWriter table(out, { { 2, report::Align::Right }, { 2, report::Align::Right }, { 3, report::Align::Right } });
+	table.text("Таблица умножения для ").text(to_string(num)).text(":").endRow();
+	for (int i = 1; i <= 10; ++i) {
+		table.cell(num).text(" x ").cell(i).text(" = ").cell(num * i).endRow();
+	}
+	table.flush();
+}
+
+void printCounts(const TextCounts& counts) {
+	cout << "Строк: " << counts.lines << "\nСлов: " << counts.words << "\nСимволов: " << counts.chars
+		<< "\nБайт: " << counts.bytes << endl;
+}
+
+void countSTR(ifstream& file) {
+	printCounts(wc::countStream(file));
+}
+
+// Файл отображается в память и считается всеми ядрами; path "-" - чтение из stdin
+void countSTR(const string& path, const ProgressFn& progress = nullptr) {
+	TextCounts counts = path == "-" ? wc::countStream(cin, progress) : wc::countFile(path, 0, progress);
+	if (progress) cerr << "\n";
+	printCounts(counts);
+}
+
+void printVocabulary(const Vocabulary& vocabulary) {
+	vector<string_view> words = vocabulary.words(true);
+	cout << "Уникальные слова (" << words.size() << " из " << vocabulary.totalWords() << "):\n";
+	for (string_view w : words) {
+		cout << w << '\n';
+	}
+	cout << flush;
+}
+
+void unikW(ifstream& file) {
+	printVocabulary(vocab::fromStream(file));
+}
+
+// Файл отображается в память, слова собираются всеми ядрами
+void unikW(const string& path) {
+	printVocabulary(vocab::fromFile(path));
+}
+
+void symb(const string& input) {
+	CharStats stats = charstats::count(input.data(), input.size(), charstats::consoleEncoding());
+
+	cout << left << setw(15) << "Символов:" << stats.chars << '\n' << setw(15) << "Пробелов:" << stats.whitespace << '\n' << setw(15) << "Знаков препинания:" << stats.punctuation << endl;
+}
+
+// Все классы символов файла за один проход всеми ядрами; файл по умолчанию считается в UTF-8
+void charStatsFile(const string& path, simd::Encoding encoding = simd::Encoding::Utf8) {
+	CharStats stats = charstats::countFile(path, encoding);
+
+	cout << left << setw(20) << "Символов:" << stats.chars << '\n' << setw(20) << "Гласных:" << stats.vowels << '\n'
+		<< setw(20) << "Согласных:" << stats.consonants << '\n' << setw(20) << "Пробелов:" << stats.whitespace << '\n'
+		<< setw(20) << "Знаков препинания:" << stats.punctuation << '\n' << setw(20) << "Цифр:" << stats.digits << endl;
+}
+
+// max_len - ширина по report::displayWidth с тем же utf8
+void tabSTR(const vector<string>& lnr, size_t max_len, ostream& out = cout, bool utf8 = consoleUtf8()) {
+	report::TableWriter table(out, { { max_len, report::Align::Right } }, utf8);
+	for (const auto& l : lnr) {
+		table.cell(l).endRow();
+	}
+	table.flush();
+}
+
+void printSummary(const numstats::Summary& s) {
+	if (s.count == 0) {
+		cerr << "Не найдено чисел" << endl;
+		return;
+	}
+	cout << std::fixed << std::setprecision(2);
+	cout << "Количество: " << s.count << "\nСреднее: " << s.mean << "\nМедиана" << (s.exactMedian ? ": " : " (приближённо): ") << s.median
+		<< "\nМода: " << s.mode << " (повторов: " << s.modeCount << ")" << "\nМинимум: " << s.minimum << "\nМаксимум: " << s.maximum
+		<< "\nДисперсия: " << s.variance << "\nСт. отклонение: " << s.deviation << endl;
+	if (s.skipped) cout << "Пропущено не чисел: " << s.skipped << endl;
+}
+
+void stats(vector<double> numbers) {
+	printSummary(numstats::summarize(move(numbers)));
+}
+
+// Числа из файла или stdin ("-") без загрузки в память; медиана приближённая
+void statsFile(const string& path) {
+	printSummary(path == "-" ? numstats::fromStream(cin) : numstats::fromFile(path));
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Файл, отображённый в память только для чтения. Пустой файл не отображается: data() == nullptr
+class MappedFile {
+	const char* ptr = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+
+	void close() {
+#ifdef _WIN32
+		if (ptr) UnmapViewOfFile(ptr);
+		if (mapping) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+		if (ptr) munmap(const_cast<char*>(ptr), length);
+		if (fd >= 0) ::close(fd);
+#endif
+	}
+
+public:
+	explicit MappedFile(const string& path) {
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) throw runtime_error("Cannot open file: " + path);
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize)) {
+			close();
+			throw runtime_error("Cannot read file size: " + path);
+		}
+		length = static_cast<size_t>(fileSize.QuadPart);
+		if (length == 0) return;
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw runtime_error("Cannot open file: " + path);
+		struct stat info;
+		if (fstat(fd, &info) != 0) {
+			close();
+			throw runtime_error("Cannot read file size: " + path);
+		}
+		length = static_cast<size_t>(info.st_size);
+		if (length == 0) return;
+		void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			ptr = static_cast<const char*>(p);
+			madvise(p, length, MADV_SEQUENTIAL);
+		}
+#endif
+		if (!ptr) {
+			close();
+			throw runtime_error("Cannot map file: " + path);
+		}
+	}
+
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const char* data() const { return ptr; }
+	size_t size() const { return length; }
+};
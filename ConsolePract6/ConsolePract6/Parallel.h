@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+inline int hardwareThreads() {
+	unsigned n = thread::hardware_concurrency();
+	return n == 0 ? 1 : static_cast<int>(n);
+}
+
+// Делит [begin, end) на куски не меньше grain и вызывает fn(lo, hi) для каждого в своём потоке
+template <typename F>
+void parallelFor(long long begin, long long end, long long grain, F fn, int threads = 0) {
+	long long total = end - begin;
+	if (total <= 0) return;
+	if (threads <= 0) threads = hardwareThreads();
+	if (grain < 1) grain = 1;
+
+	long long chunks = min<long long>(threads, (total + grain - 1) / grain);
+	if (chunks <= 1) {
+		fn(begin, end);
+		return;
+	}
+
+	vector<thread> pool;
+	pool.reserve(static_cast<size_t>(chunks - 1));
+	long long step = total / chunks, rest = total % chunks;
+	long long lo = begin;
+	for (long long c = 0; c < chunks; ++c) {
+		long long hi = lo + step + (c < rest ? 1 : 0);
+		if (c + 1 == chunks) fn(lo, hi);
+		else pool.emplace_back(fn, lo, hi);
+		lo = hi;
+	}
+	for (auto& t : pool) t.join();
+}
+
+// Устойчивая параллельная сортировка: куски сортируются в своих потоках,
+// затем сливаются попарно, каждый уровень слияний тоже параллельно
+template <typename It, typename Cmp>
+void parallelSort(It first, It last, Cmp cmp, int threads = 0) {
+	long long n = last - first;
+	if (threads <= 0) threads = hardwareThreads();
+	const long long minChunk = 1 << 14;
+	long long chunks = min<long long>(threads, n / minChunk);
+	if (chunks <= 1) {
+		stable_sort(first, last, cmp);
+		return;
+	}
+
+	vector<long long> bounds(static_cast<size_t>(chunks + 1));
+	for (long long c = 0; c <= chunks; ++c) bounds[c] = n * c / chunks;
+
+	parallelFor(0, chunks, 1, [&](long long lo, long long hi) {
+		for (long long c = lo; c < hi; ++c) stable_sort(first + bounds[c], first + bounds[c + 1], cmp);
+	}, threads);
+
+	for (long long width = 1; width < chunks; width *= 2) {
+		long long pairs = (chunks + 2 * width - 1) / (2 * width);
+		parallelFor(0, pairs, 1, [&](long long lo, long long hi) {
+			for (long long p = lo; p < hi; ++p) {
+				long long c = p * 2 * width;
+				long long mid = min(c + width, chunks), end = min(c + 2 * width, chunks);
+				if (mid < end) inplace_merge(first + bounds[c], first + bounds[mid], first + bounds[end], cmp);
+			}
+		}, threads);
+	}
+}
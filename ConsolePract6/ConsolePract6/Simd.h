@@ -0,0 +1,439 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC разрешает AVX-интринсики в любой функции, GCC/Clang - только с атрибутом target
+#if defined(SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_SSSE3
+#endif
+
+namespace simd {
+
+	struct CpuFeatures {
+		bool sse2 = false;
+		bool ssse3 = false;
+		bool avx2 = false;
+	};
+
+	inline CpuFeatures detectCpu() {
+		CpuFeatures f;
+#if defined(SIMD_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		f.sse2 = (info[3] & (1 << 26)) != 0;
+		f.ssse3 = (info[2] & (1 << 9)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool ymmSaved = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+		if (maxLeaf >= 7 && ymmSaved) {
+			__cpuidex(info, 7, 0);
+			f.avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#elif defined(SIMD_X86)
+		__builtin_cpu_init();
+		f.sse2 = __builtin_cpu_supports("sse2");
+		f.ssse3 = __builtin_cpu_supports("ssse3");
+		f.avx2 = __builtin_cpu_supports("avx2");
+#endif
+		return f;
+	}
+
+	inline const CpuFeatures& cpu() {
+		static const CpuFeatures features = detectCpu();
+		return features;
+	}
+
+	// Без инструкции POPCNT: она есть не на всех процессорах с SSE2
+	inline int popCount(uint64_t x) {
+		x = x - ((x >> 1) & 0x5555555555555555ULL);
+		x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+		x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+	}
+
+	// Пробельные байты как у isspace в локали "C": пробел и \t \n \v \f \r
+	inline bool isSpaceByte(unsigned char c) {
+		return c == ' ' || static_cast<unsigned char>(c - 9) <= 4;
+	}
+
+	// Итог сканирования текста: переводы строк, начала слов и символы UTF-8 (байты не вида 10xxxxxx)
+	struct TextScan {
+		uint64_t newlines = 0;
+		uint64_t wordStarts = 0;
+		uint64_t chars = 0;
+
+		void add(const TextScan& other) {
+			newlines += other.newlines;
+			wordStarts += other.wordStarts;
+			chars += other.chars;
+		}
+	};
+
+	// prevSpace - пробельный ли байт перед p; на выходе - пробельный ли последний байт
+	inline void scanTextScalar(const unsigned char* p, size_t n, bool& prevSpace, TextScan& out) {
+		for (size_t i = 0; i < n; ++i) {
+			unsigned char c = p[i];
+			bool space = isSpaceByte(c);
+			out.wordStarts += !space && prevSpace;
+			out.newlines += c == '\n';
+			out.chars += (c & 0xC0) != 0x80;
+			prevSpace = space;
+		}
+	}
+
+#ifdef SIMD_X86
+	// Блок 64 байта превращается в 64-битные маски: пробелы, '\n' и начала символов UTF-8.
+	// Начало слова - непробельный байт после пробельного: ~space & (space << 1 | перенос)
+	namespace sse {
+		inline void masks16(const unsigned char* p, unsigned& space, unsigned& newline, unsigned& lead) {
+			__m128i v = _mm_loadu_si128((const __m128i*)p);
+			__m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(9));
+			__m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+			__m128i blank = _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+			space = static_cast<unsigned>(_mm_movemask_epi8(blank));
+			newline = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+			lead = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65))));
+		}
+
+		inline void scanText(const unsigned char* p, size_t n, bool& prevSpace, TextScan& out) {
+			uint64_t carry = prevSpace ? 1 : 0;
+			size_t i = 0;
+			for (; i + 64 <= n; i += 64) {
+				uint64_t space = 0, newline = 0, lead = 0;
+				for (int k = 0; k < 4; ++k) {
+					unsigned s, l, c;
+					masks16(p + i + 16 * k, s, l, c);
+					space |= static_cast<uint64_t>(s) << (16 * k);
+					newline |= static_cast<uint64_t>(l) << (16 * k);
+					lead |= static_cast<uint64_t>(c) << (16 * k);
+				}
+				out.wordStarts += popCount(~space & ((space << 1) | carry));
+				out.newlines += popCount(newline);
+				out.chars += popCount(lead);
+				carry = space >> 63;
+			}
+			prevSpace = carry != 0;
+			scanTextScalar(p + i, n - i, prevSpace, out);
+		}
+	}
+
+	namespace avx2 {
+		SIMD_TARGET_AVX2 inline void masks32(const unsigned char* p, uint32_t& space, uint32_t& newline, uint32_t& lead) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)p);
+			__m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+			__m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted);
+			__m256i blank = _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+			space = static_cast<uint32_t>(_mm256_movemask_epi8(blank));
+			newline = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+			lead = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(-65))));
+		}
+
+		SIMD_TARGET_AVX2 inline void scanText(const unsigned char* p, size_t n, bool& prevSpace, TextScan& out) {
+			uint64_t carry = prevSpace ? 1 : 0;
+			size_t i = 0;
+			for (; i + 64 <= n; i += 64) {
+				uint32_t s0, l0, c0, s1, l1, c1;
+				masks32(p + i, s0, l0, c0);
+				masks32(p + i + 32, s1, l1, c1);
+				uint64_t space = s0 | static_cast<uint64_t>(s1) << 32;
+				out.wordStarts += popCount(~space & ((space << 1) | carry));
+				out.newlines += popCount(l0 | static_cast<uint64_t>(l1) << 32);
+				out.chars += popCount(c0 | static_cast<uint64_t>(c1) << 32);
+				carry = space >> 63;
+			}
+			prevSpace = carry != 0;
+			scanTextScalar(p + i, n - i, prevSpace, out);
+		}
+	}
+#endif
+
+	// Один проход по буферу: AVX2 или SSE2 по возможностям процессора, иначе побайтно
+	inline void scanText(const char* data, size_t n, bool& prevSpace, TextScan& out) {
+		const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+#ifdef SIMD_X86
+		if (cpu().avx2) { avx2::scanText(p, n, prevSpace, out); return; }
+		if (cpu().sse2) { sse::scanText(p, n, prevSpace, out); return; }
+#endif
+		scanTextScalar(p, n, prevSpace, out);
+	}
+
+	// Кодировка текста для классов символов: консоль Windows отдаёт CP866 (CP1251 после SetConsoleCP(1251)),
+	// файлы обычно в UTF-8
+	enum class Encoding { Utf8, Cp1251, Cp866 };
+
+	// Счётчики классов символов. Буквы - латиница и русский алфавит в любой из кодировок Encoding,
+	// гласные - aeiou и аеёиоуыэюя, ъ и ь не гласные и не согласные.
+	// Пунктуация - как ispunct в локали "C"; chars - байты или символы UTF-8
+	struct CharClasses {
+		uint64_t chars = 0;
+		uint64_t vowels = 0;
+		uint64_t consonants = 0;
+		uint64_t whitespace = 0;
+		uint64_t punctuation = 0;
+		uint64_t digits = 0;
+
+		void add(const CharClasses& other) {
+			chars += other.chars;
+			vowels += other.vowels;
+			consonants += other.consonants;
+			whitespace += other.whitespace;
+			punctuation += other.punctuation;
+			digits += other.digits;
+		}
+	};
+
+	// Таблицы по полубайтам: класс байта - table[младший] & table[старший] (как PSHUFB).
+	// ASCII: биты 0-1 - буквы (строки 4/6 и 5/7 таблицы ASCII), биты 2-3 - гласные в них же.
+	// Кириллица: второй байт после D0 (биты 0-3 для старших полубайтов 8-B) или D1 (биты 4-5 для 8-9)
+	struct NibbleTables {
+		uint8_t asciiLo[16], asciiHi[16];
+		uint8_t cyrHi[16], cyrLetterLo[16], cyrVowelLo[16], cyrSignLo[16];
+
+		NibbleTables() {
+			for (int i = 0; i < 16; ++i) {
+				asciiLo[i] = static_cast<uint8_t>((i >= 1 ? 1 : 0) | (i <= 0xA ? 2 : 0)
+					| (i == 1 || i == 5 || i == 9 || i == 0xF ? 4 : 0) | (i == 5 ? 8 : 0));
+				asciiHi[i] = static_cast<uint8_t>(i == 4 || i == 6 ? 0x05 : i == 5 || i == 7 ? 0x0A : 0);
+				cyrHi[i] = static_cast<uint8_t>(i == 8 ? 0x11 : i == 9 ? 0x22 : i == 0xA ? 0x04 : i == 0xB ? 0x08 : 0);
+				cyrLetterLo[i] = static_cast<uint8_t>((i == 1 ? 0x21 : 0) | 0x1E);
+				bool vowel9 = i == 0 || i == 5 || i == 8 || i == 0xE; // D0 9x и D0 Bx: А Е И О, а е и о
+				bool vowelA = i == 3 || i == 0xB || i == 0xD || i == 0xE || i == 0xF; // D0 Ax: У Ы Э Ю Я, D1 8x: у ы э ю я
+				cyrVowelLo[i] = static_cast<uint8_t>((i == 1 ? 0x01 : 0) | (vowel9 ? 0x0A : 0) | (vowelA ? 0x14 : 0) | (i == 1 ? 0x20 : 0));
+				cyrSignLo[i] = static_cast<uint8_t>(i == 0xA || i == 0xC ? 0x14 : 0); // Ъ Ь, ъ ь
+			}
+		}
+
+		uint8_t ascii(unsigned char c) const { return c < 0x80 ? static_cast<uint8_t>(asciiLo[c & 15] & asciiHi[c >> 4]) : 0; }
+
+		// 0 - не русская буква, иначе 1 - согласная, 2 - гласная, 3 - знак
+		int cyrillic(unsigned char lead, unsigned char next) const {
+			uint8_t part = lead == 0xD0 ? 0x0F : lead == 0xD1 ? 0x30 : 0;
+			if (!(cyrLetterLo[next & 15] & cyrHi[next >> 4] & part)) return 0;
+			if (cyrVowelLo[next & 15] & cyrHi[next >> 4] & part) return 2;
+			if (cyrSignLo[next & 15] & cyrHi[next >> 4] & part) return 3;
+			return 1;
+		}
+	};
+
+	inline const NibbleTables& nibbleTables() {
+		static const NibbleTables tables;
+		return tables;
+	}
+
+	// Однобайтовая кириллица по тем же полубайтам. В CP1251 и CP866 буквы идут строками по 16:
+	// бит 1 - строка А..П (гласные на 0 5 8 E), бит 2 - строка Р..Я (гласные 3 B D E F, Ъ Ь на A C), бит 4 - Ё ё
+	struct ByteTables {
+		uint8_t hi[16], letterLo[16], vowelLo[16], signLo[16];
+
+		explicit ByteTables(Encoding e) {
+			for (int i = 0; i < 16; ++i) {
+				bool yo = e == Encoding::Cp1251 ? i == 8 : i <= 1; // CP1251: A8 B8, CP866: F0 F1
+				hi[i] = 0;
+				letterLo[i] = static_cast<uint8_t>(0x03 | (yo ? 0x04 : 0));
+				vowelLo[i] = static_cast<uint8_t>((i == 0 || i == 5 || i == 8 || i == 0xE ? 0x01 : 0)
+					| (i == 3 || i == 0xB || i == 0xD || i == 0xE || i == 0xF ? 0x02 : 0) | (yo ? 0x04 : 0));
+				signLo[i] = static_cast<uint8_t>(i == 0xA || i == 0xC ? 0x02 : 0);
+			}
+			if (e == Encoding::Cp1251) {
+				hi[0xC] = hi[0xE] = 0x01;
+				hi[0xD] = hi[0xF] = 0x02;
+				hi[0xA] = hi[0xB] = 0x04;
+			}
+			else {
+				hi[0x8] = hi[0xA] = 0x01;
+				hi[0x9] = hi[0xE] = 0x02;
+				hi[0xF] = 0x04;
+			}
+		}
+
+		// 0 - не русская буква, иначе 1 - согласная, 2 - гласная, 3 - знак
+		int cyrillic(unsigned char c) const {
+			uint8_t h = hi[c >> 4];
+			if (!(letterLo[c & 15] & h)) return 0;
+			if (vowelLo[c & 15] & h) return 2;
+			if (signLo[c & 15] & h) return 3;
+			return 1;
+		}
+	};
+
+	// Для UTF-8 не используются, но ядру нужны таблицы любой кодировки
+	inline const ByteTables& byteTables(Encoding e) {
+		static const ByteTables cp1251(Encoding::Cp1251), cp866(Encoding::Cp866);
+		return e == Encoding::Cp866 ? cp866 : cp1251;
+	}
+
+	inline bool isPunctByte(unsigned char c) {
+		return c >= 0x21 && c <= 0x7E && !((c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z'));
+	}
+
+	// Побайтно по тем же таблицам; ведущий байт пары на последней позиции без продолжения пропускается
+	inline void charClassesScalar(const unsigned char* p, size_t n, Encoding encoding, CharClasses& out) {
+		const NibbleTables& t = nibbleTables();
+		const ByteTables& b = byteTables(encoding);
+		bool utf8 = encoding == Encoding::Utf8;
+		for (size_t i = 0; i < n; ++i) {
+			unsigned char c = p[i];
+			uint8_t x = t.ascii(c);
+			out.vowels += (x & 0x0C) != 0;
+			out.consonants += (x & 0x03) != 0 && (x & 0x0C) == 0;
+			out.whitespace += isSpaceByte(c);
+			out.digits += c >= '0' && c <= '9';
+			out.punctuation += isPunctByte(c);
+			out.chars += !utf8 || (c & 0xC0) != 0x80;
+			if (utf8 && (c == 0xD0 || c == 0xD1) && i + 1 < n) {
+				int kind = t.cyrillic(c, p[i + 1]);
+				out.vowels += kind == 2;
+				out.consonants += kind == 1;
+			}
+			else if (!utf8 && c >= 0x80) {
+				int kind = b.cyrillic(c);
+				out.vowels += kind == 2;
+				out.consonants += kind == 1;
+			}
+		}
+	}
+
+#ifdef SIMD_X86
+	// Ядро классификации блоками по 64 байта; O - набор операций над регистром.
+	// Для пары D0/D1 + продолжение нужен байт за блоком, поэтому векторно обрабатывается
+	// только то, после чего есть ещё хотя бы один байт; возвращает, сколько байт обработано
+#define SIMD_CHARCLASS_KERNEL(TARGET) \
+	template <typename O> TARGET size_t charClasses(const unsigned char* p, size_t n, Encoding encoding, CharClasses& out) { \
+		typedef typename O::Vec V; \
+		const NibbleTables& t = nibbleTables(); \
+		const ByteTables& b = byteTables(encoding); \
+		const bool utf8 = encoding == Encoding::Utf8; \
+		const V byteHi = O::table(b.hi), byteLetterLo = O::table(b.letterLo); \
+		const V byteVowelLo = O::table(b.vowelLo), byteSignLo = O::table(b.signLo); \
+		const V asciiLo = O::table(t.asciiLo), asciiHi = O::table(t.asciiHi), cyrHi = O::table(t.cyrHi); \
+		const V letterLo = O::table(t.cyrLetterLo), vowelLo = O::table(t.cyrVowelLo), signLo = O::table(t.cyrSignLo); \
+		const V low = O::set1(0x0F), letterBits = O::set1(0x03), vowelBits = O::set1(0x0C); \
+		const V d0Bits = O::set1(0x0F), d1Bits = O::set1(0x30); \
+		size_t i = 0; \
+		for (; i + 65 <= n; i += 64) { \
+			uint64_t vowels = 0, consonants = 0, space = 0, digits = 0, punct = 0, chars = 0; \
+			for (size_t k = 0; k < 64; k += O::width) { \
+				V v = O::load(p + i + k); \
+				V x = O::andv(O::shuffle(asciiLo, O::andv(v, low)), O::shuffle(asciiHi, O::andv(O::shiftNibble(v), low))); \
+				uint64_t letter = O::nonZero(O::andv(x, letterBits)), vowel = O::nonZero(O::andv(x, vowelBits)); \
+				uint64_t digit = O::inRange(v, '0', 9); \
+				uint64_t blank = O::inRange(v, 9, 4) | O::equal(v, ' '); \
+				uint64_t printable = O::inRange(v, 0x21, 0x7E - 0x21); \
+				uint64_t lead = O::lead(v); \
+				if (utf8) { \
+					V w = O::load(p + i + k + 1); \
+					V wl = O::andv(w, low), wh = O::shuffle(cyrHi, O::andv(O::shiftNibble(w), low)); \
+					V part = O::orv(O::andv(O::equalVec(v, 0xD0), d0Bits), O::andv(O::equalVec(v, 0xD1), d1Bits)); \
+					uint64_t cyrLetter = O::nonZero(O::andv(O::andv(O::shuffle(letterLo, wl), wh), part)); \
+					uint64_t cyrVowel = O::nonZero(O::andv(O::andv(O::shuffle(vowelLo, wl), wh), part)); \
+					uint64_t cyrSign = O::nonZero(O::andv(O::andv(O::shuffle(signLo, wl), wh), part)); \
+					vowel |= cyrVowel; \
+					letter |= cyrLetter & ~cyrSign; \
+				} \
+				else { \
+					V vl = O::andv(v, low), vh = O::shuffle(byteHi, O::andv(O::shiftNibble(v), low)); \
+					uint64_t cyrLetter = O::nonZero(O::andv(O::shuffle(byteLetterLo, vl), vh)); \
+					uint64_t cyrVowel = O::nonZero(O::andv(O::shuffle(byteVowelLo, vl), vh)); \
+					uint64_t cyrSign = O::nonZero(O::andv(O::shuffle(byteSignLo, vl), vh)); \
+					vowel |= cyrVowel; \
+					letter |= cyrLetter & ~cyrSign; \
+					lead = O::full; \
+				} \
+				vowels |= vowel << k; \
+				consonants |= (letter & ~vowel) << k; \
+				space |= blank << k; \
+				digits |= digit << k; \
+				punct |= (printable & ~letter & ~digit) << k; \
+				chars |= lead << k; \
+			} \
+			out.vowels += popCount(vowels); \
+			out.consonants += popCount(consonants); \
+			out.whitespace += popCount(space); \
+			out.digits += popCount(digits); \
+			out.punctuation += popCount(punct); \
+			out.chars += popCount(chars); \
+		} \
+		return i; \
+	}
+
+	namespace ssse3 {
+		struct U8 {
+			typedef __m128i Vec;
+			static const size_t width = 16;
+			static const uint64_t full = 0xFFFF;
+			SIMD_TARGET_SSSE3 static Vec load(const unsigned char* p) { return _mm_loadu_si128((const __m128i*)p); }
+			SIMD_TARGET_SSSE3 static Vec table(const uint8_t* t) { return _mm_loadu_si128((const __m128i*)t); }
+			SIMD_TARGET_SSSE3 static Vec set1(int c) { return _mm_set1_epi8(static_cast<char>(c)); }
+			SIMD_TARGET_SSSE3 static Vec andv(Vec a, Vec b) { return _mm_and_si128(a, b); }
+			SIMD_TARGET_SSSE3 static Vec orv(Vec a, Vec b) { return _mm_or_si128(a, b); }
+			SIMD_TARGET_SSSE3 static Vec shuffle(Vec table, Vec index) { return _mm_shuffle_epi8(table, index); }
+			SIMD_TARGET_SSSE3 static Vec shiftNibble(Vec v) { return _mm_srli_epi16(v, 4); }
+			SIMD_TARGET_SSSE3 static Vec equalVec(Vec v, int c) { return _mm_cmpeq_epi8(v, set1(c)); }
+			SIMD_TARGET_SSSE3 static uint64_t mask(Vec v) { return static_cast<uint64_t>(_mm_movemask_epi8(v)); }
+			SIMD_TARGET_SSSE3 static uint64_t equal(Vec v, int c) { return mask(equalVec(v, c)); }
+			SIMD_TARGET_SSSE3 static uint64_t nonZero(Vec v) { return mask(_mm_cmpeq_epi8(v, _mm_setzero_si128())) ^ full; }
+			// from <= v <= from + span без знака
+			SIMD_TARGET_SSSE3 static uint64_t inRange(Vec v, int from, int span) {
+				Vec shifted = _mm_sub_epi8(v, set1(from));
+				return mask(_mm_cmpeq_epi8(_mm_min_epu8(shifted, set1(span)), shifted));
+			}
+			// Не продолжение символа UTF-8 (не 10xxxxxx)
+			SIMD_TARGET_SSSE3 static uint64_t lead(Vec v) { return mask(_mm_cmpgt_epi8(v, set1(-65))); }
+		};
+
+		SIMD_CHARCLASS_KERNEL(SIMD_TARGET_SSSE3)
+	}
+
+	namespace avx2 {
+		struct U8 {
+			typedef __m256i Vec;
+			static const size_t width = 32;
+			static const uint64_t full = 0xFFFFFFFFULL;
+			SIMD_TARGET_AVX2 static Vec load(const unsigned char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+			SIMD_TARGET_AVX2 static Vec table(const uint8_t* t) { return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t)); }
+			SIMD_TARGET_AVX2 static Vec set1(int c) { return _mm256_set1_epi8(static_cast<char>(c)); }
+			SIMD_TARGET_AVX2 static Vec andv(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+			SIMD_TARGET_AVX2 static Vec orv(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+			SIMD_TARGET_AVX2 static Vec shuffle(Vec table, Vec index) { return _mm256_shuffle_epi8(table, index); }
+			SIMD_TARGET_AVX2 static Vec shiftNibble(Vec v) { return _mm256_srli_epi16(v, 4); }
+			SIMD_TARGET_AVX2 static Vec equalVec(Vec v, int c) { return _mm256_cmpeq_epi8(v, set1(c)); }
+			SIMD_TARGET_AVX2 static uint64_t mask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+			SIMD_TARGET_AVX2 static uint64_t equal(Vec v, int c) { return mask(equalVec(v, c)); }
+			SIMD_TARGET_AVX2 static uint64_t nonZero(Vec v) { return mask(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())) ^ full; }
+			SIMD_TARGET_AVX2 static uint64_t inRange(Vec v, int from, int span) {
+				Vec shifted = _mm256_sub_epi8(v, set1(from));
+				return mask(_mm256_cmpeq_epi8(_mm256_min_epu8(shifted, set1(span)), shifted));
+			}
+			SIMD_TARGET_AVX2 static uint64_t lead(Vec v) { return mask(_mm256_cmpgt_epi8(v, set1(-65))); }
+		};
+
+		SIMD_CHARCLASS_KERNEL(SIMD_TARGET_AVX2)
+	}
+
+#undef SIMD_CHARCLASS_KERNEL
+#endif
+
+	// Классы символов за один проход: AVX2 или SSSE3 по возможностям процессора, хвост - побайтно.
+	inline void charClasses(const char* data, size_t n, Encoding encoding, CharClasses& out) {
+		const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+		size_t done = 0;
+#ifdef SIMD_X86
+		if (cpu().avx2) done = avx2::charClasses<avx2::U8>(p, n, encoding, out);
+		else if (cpu().ssse3) done = ssse3::charClasses<ssse3::U8>(p, n, encoding, out);
+#endif
+		charClassesScalar(p + done, n - done, encoding, out);
+	}
+}
@@ -0,0 +1,402 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+using namespace std;
+
+namespace numstats {
+	const size_t chunkBytes = size_t(16) << 20;
+	const size_t streamBuffer = size_t(1) << 20;
+	const long long grain = 1 << 16;
+
+	// Среднее и дисперсия по Уэлфорду за один проход, слияние частичных итогов - по Чану
+	struct Moments {
+		uint64_t count = 0;
+		double mean = 0;
+		double m2 = 0;
+		double minimum = numeric_limits<double>::infinity();
+		double maximum = -numeric_limits<double>::infinity();
+
+		void add(double x) {
+			++count;
+			double delta = x - mean;
+			mean += delta / static_cast<double>(count);
+			m2 += delta * (x - mean);
+			minimum = min(minimum, x);
+			maximum = max(maximum, x);
+		}
+
+		void merge(const Moments& other) {
+			if (other.count == 0) return;
+			if (count == 0) {
+				*this = other;
+				return;
+			}
+			double n1 = static_cast<double>(count), n2 = static_cast<double>(other.count), n = n1 + n2;
+			double delta = other.mean - mean;
+			mean += delta * n2 / n;
+			m2 += other.m2 + delta * delta * n1 * n2 / n;
+			count += other.count;
+			minimum = min(minimum, other.minimum);
+			maximum = max(maximum, other.maximum);
+		}
+
+		// Выборочная дисперсия (делитель n - 1)
+		double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0; }
+	};
+
+	// Счётчик повторов для моды: открытая адресация по битам числа, -0.0 и 0.0 - одно значение
+	class ModeCounter {
+		struct Slot {
+			uint64_t key;
+			uint64_t count; // 0 - пустая ячейка
+		};
+		vector<Slot> slots;
+		size_t used = 0;
+		size_t mask = 0;
+
+		static uint64_t mix(uint64_t k) {
+			k ^= k >> 33;
+			k *= 0xFF51AFD7ED558CCDULL;
+			k ^= k >> 33;
+			k *= 0xC4CEB9FE1A85EC53ULL;
+			return k ^ (k >> 33);
+		}
+
+		void addKey(uint64_t key, uint64_t count) {
+			size_t i = static_cast<size_t>(mix(key)) & mask;
+			for (; slots[i].count; i = (i + 1) & mask) {
+				if (slots[i].key == key) {
+					slots[i].count += count;
+					return;
+				}
+			}
+			slots[i] = Slot{ key, count };
+			if (++used * 2 > slots.size()) grow();
+		}
+
+		void grow() {
+			vector<Slot> old(slots.size() * 2, Slot{ 0, 0 });
+			old.swap(slots);
+			mask = slots.size() - 1;
+			used = 0;
+			for (const Slot& s : old) if (s.count) addKey(s.key, s.count);
+		}
+
+		static double value(uint64_t key) {
+			double x;
+			memcpy(&x, &key, sizeof x);
+			return x;
+		}
+
+	public:
+		ModeCounter() : slots(64, Slot{ 0, 0 }), mask(63) {}
+
+		void add(double x) {
+			if (x == 0) x = 0.0;
+			uint64_t key;
+			memcpy(&key, &x, sizeof key);
+			addKey(key, 1);
+		}
+
+		void merge(const ModeCounter& other) {
+			for (const Slot& s : other.slots) if (s.count) addKey(s.key, s.count);
+		}
+
+		size_t distinct() const { return used; }
+
+		// Самое частое значение; при равенстве - меньшее, как раньше при обходе map
+		bool mode(double& result, uint64_t& count) const {
+			count = 0;
+			for (const Slot& s : slots) {
+				if (!s.count) continue;
+				double x = value(s.key);
+				if (s.count > count || (s.count == count && x < result)) {
+					count = s.count;
+					result = x;
+				}
+			}
+			return count > 0;
+		}
+	};
+
+	// t-digest: поток сжимается в центроиды, мелкие у краёв распределения и крупные в середине.
+	// Сливается из частей так же, как строится, поэтому годится для потоков и для нескольких потоков
+	class TDigest {
+		struct Centroid {
+			double mean;
+			double weight;
+		};
+		double compression;
+		vector<Centroid> centroids;
+		vector<double> pending; // точки с весом 1, ещё не отсортированные
+		double total = 0;
+		double lo = numeric_limits<double>::infinity();
+		double hi = -numeric_limits<double>::infinity();
+
+		// Один проход по центроидам, упорядоченным по mean: соседние сливаются, пока вес укладывается в предел для их квантиля
+		void rebuild(const vector<Centroid>& sorted) {
+			centroids.clear();
+			if (sorted.empty()) return;
+			centroids.push_back(sorted[0]);
+			double before = 0;
+			for (size_t i = 1; i < sorted.size(); ++i) {
+				Centroid& cur = centroids.back();
+				double weight = cur.weight + sorted[i].weight;
+				double q0 = before / total, q2 = (before + weight) / total;
+				if (weight <= 4 * total * min(q0 * (1 - q0), q2 * (1 - q2)) / compression) {
+					cur.mean += (sorted[i].mean - cur.mean) * sorted[i].weight / weight;
+					cur.weight = weight;
+				}
+				else {
+					before += cur.weight;
+					centroids.push_back(sorted[i]);
+				}
+			}
+		}
+
+		// Сортируются только новые точки, с готовыми центроидами они сливаются за линейное время
+		static vector<Centroid> mergeSorted(const vector<Centroid>& a, vector<double>& points) {
+			sort(points.begin(), points.end());
+			vector<Centroid> out;
+			out.reserve(a.size() + points.size());
+			size_t i = 0, j = 0;
+			while (i < a.size() || j < points.size()) {
+				if (j == points.size() || (i < a.size() && a[i].mean <= points[j])) out.push_back(a[i++]);
+				else out.push_back(Centroid{ points[j++], 1 });
+			}
+			points.clear();
+			return out;
+		}
+
+		void compress() {
+			if (pending.empty()) return;
+			rebuild(mergeSorted(centroids, pending));
+		}
+
+	public:
+		explicit TDigest(double compression = 200) : compression(compression) {}
+
+		void add(double x) {
+			pending.push_back(x);
+			total += 1;
+			lo = min(lo, x);
+			hi = max(hi, x);
+			if (pending.size() >= static_cast<size_t>(compression) * 32) compress();
+		}
+
+		void merge(const TDigest& other) {
+			if (other.total == 0) return;
+			vector<double> points(other.pending);
+			vector<Centroid> incoming = mergeSorted(other.centroids, points);
+			compress();
+			vector<Centroid> all(centroids.size() + incoming.size());
+			std::merge(centroids.begin(), centroids.end(), incoming.begin(), incoming.end(), all.begin(),
+				[](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+			total += other.total;
+			lo = min(lo, other.lo);
+			hi = max(hi, other.hi);
+			rebuild(all);
+		}
+
+		// Ни одна точка ещё не слилась с соседней - квантили точные
+		bool exact() {
+			compress();
+			return all_of(centroids.begin(), centroids.end(), [](const Centroid& c) { return c.weight == 1; });
+		}
+
+		// Линейная интерполяция между центрами соседних центроидов; пока все веса единичные - точно
+		double quantile(double q) {
+			compress();
+			if (centroids.empty()) return numeric_limits<double>::quiet_NaN();
+			if (centroids.size() == 1) return centroids[0].mean;
+			double target = q * total;
+			const Centroid& first = centroids.front();
+			if (target < first.weight / 2) return lo + (first.mean - lo) * target / (first.weight / 2);
+			double cum = 0;
+			for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+				const Centroid& a = centroids[i];
+				const Centroid& b = centroids[i + 1];
+				double from = cum + a.weight / 2, to = cum + a.weight + b.weight / 2;
+				if (target <= to) return a.mean + (b.mean - a.mean) * (target - from) / (to - from);
+				cum += a.weight;
+			}
+			const Centroid& last = centroids.back();
+			double from = total - last.weight / 2;
+			return last.mean + (hi - last.mean) * min(1.0, (target - from) / (last.weight / 2));
+		}
+	};
+
+	struct Summary {
+		uint64_t count = 0;
+		uint64_t skipped = 0; // NaN и нечисловые слова
+		uint64_t distinct = 0;
+		double mean = 0;
+		double variance = 0;
+		double deviation = 0;
+		double minimum = 0;
+		double maximum = 0;
+		double median = 0;
+		bool exactMedian = true;
+		double mode = 0;
+		uint64_t modeCount = 0;
+	};
+
+	// Частичный итог одного потока: всё, кроме медианы, сливается без потерь
+	struct Accumulator {
+		Moments moments;
+		ModeCounter modes;
+		uint64_t skipped = 0;
+
+		void add(double x) {
+			if (isnan(x)) {
+				++skipped;
+				return;
+			}
+			moments.add(x);
+			modes.add(x);
+		}
+
+		void merge(const Accumulator& other) {
+			moments.merge(other.moments);
+			modes.merge(other.modes);
+			skipped += other.skipped;
+		}
+
+		Summary summary() const {
+			Summary s;
+			s.count = moments.count;
+			s.skipped = skipped;
+			s.distinct = modes.distinct();
+			if (s.count == 0) return s;
+			s.mean = moments.mean;
+			s.variance = moments.variance();
+			s.deviation = sqrt(s.variance);
+			s.minimum = moments.minimum;
+			s.maximum = moments.maximum;
+			modes.mode(s.mode, s.modeCount);
+			return s;
+		}
+	};
+
+	// Для потоков неизвестной длины: медиана приближённо по t-digest
+	struct StreamStats {
+		Accumulator values;
+		TDigest digest;
+
+		void add(double x) {
+			values.add(x);
+			if (!isnan(x)) digest.add(x);
+		}
+
+		void merge(const StreamStats& other) {
+			values.merge(other.values);
+			digest.merge(other.digest);
+		}
+
+		Summary summary() {
+			Summary s = values.summary();
+			if (s.count == 0) return s;
+			s.median = digest.quantile(0.5);
+			s.exactMedian = digest.exact();
+			return s;
+		}
+	};
+
+	// Все числа уже в памяти: моменты и мода по кускам во всех потоках, точная медиана через nth_element
+	inline Summary summarize(vector<double> values, int threads = 0) {
+		Accumulator total;
+		mutex lock;
+		parallelFor(0, static_cast<long long>(values.size()), grain, [&](long long lo, long long hi) {
+			Accumulator local;
+			for (long long i = lo; i < hi; ++i) local.add(values[i]);
+			lock_guard<mutex> guard(lock);
+			total.merge(local);
+		}, threads);
+
+		Summary s = total.summary();
+		if (s.count == 0) return s;
+		values.erase(remove_if(values.begin(), values.end(), [](double x) { return isnan(x); }), values.end());
+		size_t half = values.size() / 2;
+		nth_element(values.begin(), values.begin() + half, values.end());
+		s.median = values[half];
+		if (values.size() % 2 == 0) s.median = (*max_element(values.begin(), values.begin() + half) + s.median) / 2;
+		return s;
+	}
+
+	// Слово, которое не разбирается как число целиком, пропускается
+	inline void parseWords(const char* p, const char* end, StreamStats& out) {
+		while (p < end) {
+			while (p < end && simd::isSpaceByte(static_cast<unsigned char>(*p))) ++p;
+			const char* start = p;
+			while (p < end && !simd::isSpaceByte(static_cast<unsigned char>(*p))) ++p;
+			if (start == p) break;
+			if (*start == '+') ++start;
+			double x;
+			from_chars_result r = from_chars(start, p, x);
+			if (r.ec == errc() && r.ptr == p) out.add(x);
+			else ++out.values.skipped;
+		}
+	}
+
+	// Куски по chunkBytes, границы сдвигаются за конец слова; каждый поток копит свой StreamStats
+	inline Summary fromBuffer(const char* data, size_t size, int threads = 0) {
+		StreamStats total;
+		size_t chunks = (size + chunkBytes - 1) / chunkBytes;
+		vector<size_t> bounds(chunks + 1, size);
+		if (chunks > 0) bounds[0] = 0;
+		for (size_t c = 1; c < chunks; ++c) {
+			size_t at = max(c * chunkBytes, bounds[c - 1]);
+			while (at < size && !simd::isSpaceByte(static_cast<unsigned char>(data[at]))) ++at;
+			bounds[c] = at;
+		}
+
+		if (threads <= 0) threads = hardwareThreads();
+		atomic<size_t> next(0);
+		mutex lock;
+		parallelFor(0, min<long long>(threads, static_cast<long long>(chunks)), 1, [&](long long, long long) {
+			StreamStats local;
+			for (size_t c = next++; c < chunks; c = next++) parseWords(data + bounds[c], data + bounds[c + 1], local);
+			lock_guard<mutex> guard(lock);
+			total.merge(local);
+		}, threads);
+		return total.summary();
+	}
+
+	inline Summary fromFile(const string& path, int threads = 0) {
+		MappedFile file(path);
+		return fromBuffer(file.data(), file.size(), threads);
+	}
+
+	// Потоковый режим: недочитанное слово в конце блока переносится в начало следующего
+	inline Summary fromStream(istream& in) {
+		StreamStats total;
+		vector<char> buffer(streamBuffer);
+		size_t carry = 0;
+		while (in) {
+			if (carry == buffer.size()) buffer.resize(buffer.size() * 2);
+			in.read(buffer.data() + carry, static_cast<streamsize>(buffer.size() - carry));
+			size_t got = carry + static_cast<size_t>(in.gcount());
+			if (got == carry) break;
+			size_t cut = got;
+			while (cut > 0 && !simd::isSpaceByte(static_cast<unsigned char>(buffer[cut - 1]))) --cut;
+			parseWords(buffer.data(), buffer.data() + cut, total);
+			carry = got - cut;
+			memmove(buffer.data(), buffer.data() + cut, carry);
+		}
+		parseWords(buffer.data(), buffer.data() + carry, total);
+		return total.summary();
+	}
+}
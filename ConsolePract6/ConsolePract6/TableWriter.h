@@ -0,0 +1,118 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+namespace report {
+	enum class Align { Left, Right };
+
+	struct Column {
+		size_t width;
+		Align align;
+	};
+
+	// Ширина строки на экране. Однобайтовый текст (CP866/CP1251 консоли Windows) - байты, как у setw;
+	// в UTF-8 - символы: байты продолжения 10xxxxxx места не занимают
+	inline size_t displayWidth(string_view s, bool utf8 = false) {
+		if (!utf8) return s.size();
+		size_t width = 0;
+		for (unsigned char c : s) width += (c & 0xC0) != 0x80;
+		return width;
+	}
+
+	// Табличный вывод в собственный буфер: числа через to_chars, выравнивание - готовыми
+	// пробелами, в поток - большими блоками. Без flush на каждой строке, как у endl
+	class TableWriter {
+		static constexpr size_t blockSize = size_t(64) << 10;
+		ostream& out;
+		string buffer;
+		vector<Column> columns;
+		bool utf8;
+		size_t column = 0;
+
+		void pad(size_t n) {
+			static const string spaces(256, ' ');
+			for (; n > spaces.size(); n -= spaces.size()) buffer += spaces;
+			buffer.append(spaces, 0, n);
+		}
+
+		// Ячейка по ширине очередного столбца; ячейки сверх описанных столбцов выводятся как есть
+		void put(string_view s, size_t width) {
+			if (column >= columns.size()) {
+				buffer.append(s.data(), s.size());
+				return;
+			}
+			const Column& c = columns[column++];
+			size_t fill = c.width > width ? c.width - width : 0;
+			if (c.align == Align::Right) pad(fill);
+			buffer.append(s.data(), s.size());
+			if (c.align == Align::Left) pad(fill);
+		}
+
+	public:
+		// utf8 - ширина ячеек по символам UTF-8, иначе по байтам
+		explicit TableWriter(ostream& out, vector<Column> columns = vector<Column>(), bool utf8 = false)
+			: out(out), columns(move(columns)), utf8(utf8) {
+			buffer.reserve(blockSize + 256);
+		}
+
+		// Ошибку записи сообщает только явный flush(), деструктор не бросает
+		~TableWriter() {
+			if (!buffer.empty()) out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+		}
+
+		TableWriter(const TableWriter&) = delete;
+		TableWriter& operator=(const TableWriter&) = delete;
+
+		TableWriter& cell(string_view s) {
+			put(s, displayWidth(s, utf8));
+			return *this;
+		}
+
+		template <typename T, typename = typename enable_if<is_integral<T>::value>::type>
+		TableWriter& cell(T x) {
+			char digits[24];
+			to_chars_result r = to_chars(digits, digits + sizeof digits, x);
+			size_t n = static_cast<size_t>(r.ptr - digits);
+			put(string_view(digits, n), n);
+			return *this;
+		}
+
+		// Дробное число с фиксированным числом знаков, как fixed << setprecision
+		TableWriter& cell(double x, int precision) {
+			char digits[352];
+			to_chars_result r = to_chars(digits, digits + sizeof digits, x, chars_format::fixed, precision);
+			if (r.ec != errc()) throw runtime_error("Number does not fit the cell buffer");
+			size_t n = static_cast<size_t>(r.ptr - digits);
+			put(string_view(digits, n), n);
+			return *this;
+		}
+
+		// Текст между ячейками, не занимающий столбец
+		TableWriter& text(string_view s) {
+			buffer.append(s.data(), s.size());
+			return *this;
+		}
+
+		TableWriter& endRow() {
+			buffer += '\n';
+			column = 0;
+			if (buffer.size() >= blockSize) flush();
+			return *this;
+		}
+
+		void flush() {
+			if (buffer.empty()) return;
+			out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+			buffer.clear();
+			if (!out) throw runtime_error("Write failed");
+		}
+	};
+}
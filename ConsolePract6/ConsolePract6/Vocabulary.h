@@ -0,0 +1,344 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+using namespace std;
+
+namespace vocab {
+	// Таблица каждого потока разбита на шарды по старшим битам хеша: при слиянии
+	// шард s собирается из шардов s всех потоков независимо от остальных
+	const int shardBits = 6;
+	const size_t shardCount = size_t(1) << shardBits;
+	const size_t chunkBytes = size_t(8) << 20;
+	const size_t streamBuffer = size_t(4) << 20;
+
+	// По 8 байт за шаг с перемешиванием умножением
+	inline uint64_t hashBytes(const char* p, size_t n) {
+		const uint64_t k = 0x9E3779B97F4A7C15ULL;
+		uint64_t h = n * k;
+		for (; n >= 8; p += 8, n -= 8) {
+			uint64_t block;
+			memcpy(&block, p, 8);
+			h = (h ^ block) * k;
+			h ^= h >> 29;
+		}
+		if (n > 0) {
+			uint64_t block = 0;
+			memcpy(&block, p, n);
+			h = (h ^ block) * k;
+		}
+		h ^= h >> 32;
+		h *= 0xD6E8FEB86659FD93ULL;
+		return h ^ (h >> 32);
+	}
+
+	// Ключи копируются в большие блоки и не перемещаются, пока жива арена
+	class Arena {
+		static constexpr size_t blockSize = size_t(1) << 20;
+		vector<unique_ptr<char[]>> blocks;
+		char* cur = nullptr;
+		size_t left = 0;
+
+	public:
+		const char* store(const char* p, size_t n) {
+			if (n > left) {
+				size_t size = max(blockSize, n);
+				blocks.emplace_back(new char[size]);
+				cur = blocks.back().get();
+				left = size;
+			}
+			char* at = cur;
+			memcpy(at, p, n);
+			cur += n;
+			left -= n;
+			return at;
+		}
+	};
+
+	struct Entry {
+		uint64_t hash;
+		const char* key; // nullptr - пустая ячейка
+		uint32_t length;
+		uint64_t count;
+	};
+
+	// Открытая адресация с линейным пробированием, заполнение не выше половины.
+	// Хеш хранится в ячейке: при росте строки заново не хешируются
+	class WordTable {
+		vector<Entry> slots;
+		size_t used = 0;
+		size_t mask = 0;
+
+		void grow() {
+			vector<Entry> old(slots.size() * 2, Entry{ 0, nullptr, 0, 0 });
+			old.swap(slots);
+			mask = slots.size() - 1;
+			for (const Entry& e : old) {
+				if (!e.key) continue;
+				size_t i = static_cast<size_t>(e.hash) & mask;
+				while (slots[i].key) i = (i + 1) & mask;
+				slots[i] = e;
+			}
+		}
+
+	public:
+		explicit WordTable(size_t capacity = 256) {
+			size_t size = 16;
+			while (size < capacity * 2) size *= 2;
+			slots.assign(size, Entry{ 0, nullptr, 0, 0 });
+			mask = size - 1;
+		}
+
+		// arena == nullptr - ключ уже лежит в стабильной памяти и не копируется
+		void add(uint64_t hash, const char* p, size_t n, uint64_t count, Arena* arena) {
+			size_t i = static_cast<size_t>(hash) & mask;
+			for (; slots[i].key; i = (i + 1) & mask) {
+				const Entry& e = slots[i];
+				if (e.hash == hash && e.length == n && memcmp(e.key, p, n) == 0) {
+					slots[i].count += count;
+					return;
+				}
+			}
+			slots[i] = Entry{ hash, arena ? arena->store(p, n) : p, static_cast<uint32_t>(n), count };
+			if (++used * 2 > slots.size()) grow();
+		}
+
+		const Entry* find(uint64_t hash, const char* p, size_t n) const {
+			for (size_t i = static_cast<size_t>(hash) & mask; slots[i].key; i = (i + 1) & mask) {
+				const Entry& e = slots[i];
+				if (e.hash == hash && e.length == n && memcmp(e.key, p, n) == 0) return &e;
+			}
+			return nullptr;
+		}
+
+		size_t size() const { return used; }
+
+		template <typename F>
+		void forEach(F f) const {
+			for (const Entry& e : slots) if (e.key) f(e);
+		}
+	};
+
+	// Действие для байта. Хвост символа UTF-8 остаётся, если осталось его начало:
+	// LeadKeep - кириллица и прочие буквы, LeadDrop - знаки U+0080-00BF (« » и т.п.) и U+2000-2FFF (тире, кавычки)
+	enum ByteAction : uint8_t {
+		Separator = 1, // пробельный байт - конец слова
+		Append = 2,    // ASCII-буква или начало оставляемого символа
+		AppendTail = 4,
+		KeepTail = 8,
+		DropTail = 16
+	};
+
+	struct ByteTable {
+		uint8_t action[256];
+		char fold[256];
+
+		ByteTable() {
+			for (int b = 0; b < 256; ++b) {
+				unsigned char c = static_cast<unsigned char>(b);
+				fold[b] = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+				if (simd::isSpaceByte(c)) action[b] = Separator;
+				else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) action[b] = Append;
+				else if (c < 0x80) action[b] = 0;
+				else if (c < 0xC0) action[b] = AppendTail;
+				else if (c == 0xC2 || c == 0xE2) action[b] = DropTail;
+				else if (c <= 0xF4 && c >= 0xC3) action[b] = Append | KeepTail;
+				else action[b] = DropTail;
+			}
+		}
+	};
+
+	inline const ByteTable& byteTable() {
+		static const ByteTable table;
+		return table;
+	}
+
+	// Состояние разбора между буферами: слово может быть разрезано границей буфера
+	struct TokenState {
+		vector<char> word = vector<char>(64);
+		size_t length = 0;
+		unsigned keepTail = 0;
+	};
+
+	// Слово - последовательность непробельных байт, в нём остаются только буквы, ASCII
+	// переводится в нижний регистр прямо в переиспользуемом буфере state.word.
+	// Байт пишется всегда, а длина растёт только для оставляемых - без ветвлений на классе байта
+	template <typename Emit>
+	void tokenize(const char* p, size_t n, TokenState& state, Emit emit) {
+		const ByteTable& table = byteTable();
+		char* word = state.word.data();
+		size_t length = state.length, capacity = state.word.size();
+		unsigned keepTail = state.keepTail;
+		for (size_t i = 0; i < n; ++i) {
+			unsigned char c = static_cast<unsigned char>(p[i]);
+			unsigned action = table.action[c];
+			if (action & Separator) {
+				if (length) emit(static_cast<const char*>(word), length);
+				length = 0;
+				continue;
+			}
+			if (length == capacity) {
+				state.word.resize(capacity * 2);
+				word = state.word.data();
+				capacity = state.word.size();
+			}
+			word[length] = table.fold[c];
+			length += ((action >> 1) | ((action >> 2) & keepTail)) & 1;
+			keepTail = (keepTail & ~(action >> 4)) | ((action >> 3) & 1);
+		}
+		state.length = length;
+		state.keepTail = keepTail & 1;
+	}
+
+	template <typename Emit>
+	void finishTokens(TokenState& state, Emit emit) {
+		if (state.length) emit(static_cast<const char*>(state.word.data()), state.length);
+		state.length = 0;
+	}
+
+	// Набор одного потока: шарды таблиц и арена для их ключей
+	struct LocalSet {
+		vector<WordTable> shards;
+		unique_ptr<Arena> arena;
+		uint64_t total = 0;
+
+		LocalSet() : shards(shardCount), arena(new Arena()) {}
+
+		void add(const char* p, size_t n) {
+			uint64_t h = hashBytes(p, n);
+			shards[static_cast<size_t>(h >> (64 - shardBits))].add(h, p, n, 1, arena.get());
+			++total;
+		}
+	};
+}
+
+// Словарь текста: уникальные нормализованные слова и число их вхождений.
+// Ключи живут в аренах потоков, которые собирали словарь
+class Vocabulary {
+	vector<vocab::WordTable> shards;
+	vector<unique_ptr<vocab::Arena>> arenas;
+	uint64_t total = 0;
+
+public:
+	Vocabulary() : shards(vocab::shardCount) {}
+
+	// Слияние наборов потоков: каждый шард собирается в своём потоке
+	static Vocabulary merge(vector<vocab::LocalSet>& locals, int threads = 0) {
+		Vocabulary result;
+		if (locals.size() == 1) result.shards.swap(locals[0].shards);
+		else {
+			parallelFor(0, static_cast<long long>(vocab::shardCount), 1, [&](long long lo, long long hi) {
+				for (long long s = lo; s < hi; ++s) {
+					vocab::WordTable& target = result.shards[static_cast<size_t>(s)];
+					for (vocab::LocalSet& local : locals) {
+						local.shards[static_cast<size_t>(s)].forEach([&](const vocab::Entry& e) {
+							target.add(e.hash, e.key, e.length, e.count, nullptr);
+						});
+						local.shards[static_cast<size_t>(s)] = vocab::WordTable();
+					}
+				}
+			}, threads);
+		}
+		for (vocab::LocalSet& local : locals) {
+			result.total += local.total;
+			result.arenas.push_back(move(local.arena));
+		}
+		return result;
+	}
+
+	size_t size() const {
+		size_t n = 0;
+		for (const vocab::WordTable& t : shards) n += t.size();
+		return n;
+	}
+
+	uint64_t totalWords() const { return total; }
+
+	// Число вхождений уже нормализованного слова
+	uint64_t count(string_view word) const {
+		uint64_t h = vocab::hashBytes(word.data(), word.size());
+		const vocab::Entry* e = shards[static_cast<size_t>(h >> (64 - vocab::shardBits))].find(h, word.data(), word.size());
+		return e ? e->count : 0;
+	}
+
+	// Представления действительны, пока жив словарь
+	vector<string_view> words(bool sorted = false, int threads = 0) const {
+		vector<string_view> result;
+		result.reserve(size());
+		for (const vocab::WordTable& t : shards)
+			t.forEach([&](const vocab::Entry& e) { result.emplace_back(e.key, e.length); });
+		if (sorted) parallelSort(result.begin(), result.end(), less<string_view>(), threads);
+		return result;
+	}
+
+	template <typename F>
+	void forEach(F f) const {
+		for (const vocab::WordTable& t : shards)
+			t.forEach([&](const vocab::Entry& e) { f(string_view(e.key, e.length), e.count); });
+	}
+};
+
+namespace vocab {
+	// Буфер делится на куски, границы сдвигаются за ближайший пробельный байт,
+	// чтобы слово не разрезалось; потоки берут куски по очереди
+	inline Vocabulary fromBuffer(const char* data, size_t size, int threads = 0) {
+		if (threads <= 0) threads = hardwareThreads();
+		size_t chunks = max<size_t>(1, (size + chunkBytes - 1) / chunkBytes);
+		vector<size_t> bounds(chunks + 1, size);
+		bounds[0] = 0;
+		for (size_t c = 1; c < chunks; ++c) {
+			size_t at = max(c * chunkBytes, bounds[c - 1]);
+			while (at < size && !simd::isSpaceByte(static_cast<unsigned char>(data[at - 1]))) ++at;
+			bounds[c] = at;
+		}
+
+		int workers = static_cast<int>(min<size_t>(static_cast<size_t>(threads), chunks));
+		vector<LocalSet> locals(static_cast<size_t>(workers));
+		atomic<size_t> next(0);
+		parallelFor(0, workers, 1, [&](long long lo, long long hi) {
+			for (long long w = lo; w < hi; ++w) {
+				LocalSet& local = locals[static_cast<size_t>(w)];
+				auto emit = [&](const char* p, size_t n) { local.add(p, n); };
+				TokenState state;
+				for (size_t c = next++; c < chunks; c = next++) {
+					tokenize(data + bounds[c], bounds[c + 1] - bounds[c], state, emit);
+					finishTokens(state, emit);
+				}
+			}
+		}, workers);
+		return Vocabulary::merge(locals, threads);
+	}
+
+	inline Vocabulary fromFile(const string& path, int threads = 0) {
+		MappedFile file(path);
+		return fromBuffer(file.data(), file.size(), threads);
+	}
+
+	// Потоковый режим: один поток, чтение блоками streamBuffer
+	inline Vocabulary fromStream(istream& in) {
+		vector<LocalSet> locals(1);
+		LocalSet& local = locals[0];
+		auto emit = [&](const char* p, size_t n) { local.add(p, n); };
+		vector<char> buffer(streamBuffer);
+		TokenState state;
+		while (in) {
+			in.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+			size_t got = static_cast<size_t>(in.gcount());
+			if (got == 0) break;
+			tokenize(buffer.data(), got, state, emit);
+		}
+		finishTokens(state, emit);
+		return Vocabulary::merge(locals);
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+using namespace std;
+
+// Итог подсчёта в духе wc. Строки считаются как у getline: последняя строка без '\n' тоже строка.
+// Слово - непрерывная последовательность непробельных байт, chars - символы UTF-8
+struct TextCounts {
+	uint64_t lines = 0;
+	uint64_t words = 0;
+	uint64_t chars = 0;
+	uint64_t bytes = 0;
+};
+
+// Вызывается по мере обработки: сколько байт готово и сколько всего (0, если размер неизвестен)
+typedef function<void(uint64_t done, uint64_t total)> ProgressFn;
+
+namespace wc {
+	// Кусок работы одного потока; заодно шаг отчёта о прогрессе
+	const size_t chunkBytes = size_t(16) << 20;
+	const size_t streamBuffer = size_t(1) << 20;
+
+	inline TextCounts finish(const simd::TextScan& scan, uint64_t bytes, bool lastIsNewline) {
+		TextCounts result;
+		result.lines = scan.newlines + (bytes > 0 && !lastIsNewline ? 1 : 0);
+		result.words = scan.wordStarts;
+		result.chars = scan.chars;
+		result.bytes = bytes;
+		return result;
+	}
+
+	// Буфер делится на куски по chunkBytes, границы сдвигаются за ближайший '\n', поэтому
+	// слово не разрезается и каждый кусок начинается как после пробела. Потоки берут куски по очереди
+	inline TextCounts countBuffer(const char* data, size_t size, int threads = 0, const ProgressFn& progress = nullptr) {
+		if (size == 0) return TextCounts();
+		size_t chunks = (size + chunkBytes - 1) / chunkBytes;
+		vector<size_t> bounds(chunks + 1, size);
+		bounds[0] = 0;
+		for (size_t c = 1; c < chunks; ++c) {
+			size_t at = max(c * chunkBytes, bounds[c - 1]);
+			if (at < size && data[at - 1] != '\n') {
+				const void* newline = memchr(data + at, '\n', size - at);
+				at = newline ? static_cast<const char*>(newline) - data + 1 : size;
+			}
+			bounds[c] = at;
+		}
+
+		if (threads <= 0) threads = hardwareThreads();
+		atomic<size_t> next(0);
+		atomic<uint64_t> done(0);
+		mutex lock;
+		simd::TextScan total;
+		parallelFor(0, min<long long>(threads, static_cast<long long>(chunks)), 1, [&](long long, long long) {
+			simd::TextScan local;
+			for (size_t c = next++; c < chunks; c = next++) {
+				bool prevSpace = true;
+				simd::scanText(data + bounds[c], bounds[c + 1] - bounds[c], prevSpace, local);
+				uint64_t finished = done += bounds[c + 1] - bounds[c];
+				if (progress) {
+					lock_guard<mutex> guard(lock);
+					progress(finished, size);
+				}
+			}
+			lock_guard<mutex> guard(lock);
+			total.add(local);
+		}, threads);
+		return finish(total, size, data[size - 1] == '\n');
+	}
+
+	inline TextCounts countFile(const string& path, int threads = 0, const ProgressFn& progress = nullptr) {
+		MappedFile file(path);
+		return countBuffer(file.data(), file.size(), threads, progress);
+	}
+
+	// Потоковый режим (stdin, каналы): один поток, буфер streamBuffer, состояние между блоками -
+	// пробельный ли последний байт
+	inline TextCounts countStream(istream& in, const ProgressFn& progress = nullptr) {
+		vector<char> buffer(streamBuffer);
+		simd::TextScan scan;
+		bool prevSpace = true, lastIsNewline = false;
+		uint64_t bytes = 0;
+		while (in) {
+			in.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+			size_t got = static_cast<size_t>(in.gcount());
+			if (got == 0) break;
+			simd::scanText(buffer.data(), got, prevSpace, scan);
+			lastIsNewline = buffer[got - 1] == '\n';
+			bytes += got;
+			if (progress) progress(bytes, 0);
+		}
+		return finish(scan, bytes, lastIsNewline);
+	}
+}
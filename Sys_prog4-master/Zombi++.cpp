@@ -1,8 +1,9 @@
-﻿#include <iostream>
+#include <iostream>
 #include <vector>
 #include <set>
 #include <cmath>
 #include <string>
+#include <algorithm>
 using namespace std;
 
 int zadano1(int* ukaz, int size) {
@@ -193,17 +194,8 @@ void zadano9()
 
     }
     cout << endl;
-    //сортировка массива методом пузырька
-    for (int i = 0; i < sizeo - 1; ++i) {
-        for (int j = 0; j < sizeo - i - 1; ++j) {
-            if (*(arr + j) > *(arr + j + 1)) {
-                //меняем местами элементы
-                int temp = *(arr + j);
-                *(arr + j) = *(arr + j + 1);
-                *(arr + j + 1) = temp;
-            }
-        }
-    }
+    //сортировка массива (introsort из стандартной библиотеки вместо пузырька)
+    sort(arr, arr + sizeo);
     cout << "Отсортированный массив: ";
     for (int i = 0; i < sizeo; ++i) {
         cout << arr[i] << " ";